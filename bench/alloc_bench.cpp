@@ -0,0 +1,161 @@
+/**
+ * @file bench/alloc_bench.cpp
+ *
+ * @brief Counts heap allocations per match between a worker and the printer.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file replaces the global operator new with a counting version and
+ * sends the matches of many files from a worker-like thread to a
+ * printer-like thread through each channel type. Three payloads are
+ * compared: a record per line owning its own copy of the path and the line
+ * (how matches were sent before MatchSlab), a new MatchSlab per file, and
+ * MatchSlabs taken from and returned to the MatchSlabPool as the search
+ * does. The allocations per match and the time taken are printed for each
+ * run.
+ *
+ * Usage: bin/alloc_bench [matches] [matches per file]
+ */
+
+#include "channel.h"
+#include "match.h"
+#include "match_pool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static std::atomic<unsigned long> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Long enough that neither string fits in the small-string buffer
+static const std::filesystem::path filePath = "/some/fairly/deep/source/tree/module/file_name.cpp";
+static const std::string line = "    if (value != nullptr && value->count > threshold) { return value; }";
+
+// A match that owns its path and line, as sent before MatchSlab
+struct OwnedMatch {
+    std::thread::id thread_id;
+    std::filesystem::path file_path;
+    int line_number;
+    std::string line_content;
+};
+
+/**
+ * @brief Send files x perFile owned per-line records, one batch per file
+ */
+static void sendOwned(channel<OwnedMatch>* chan, long files, long perFile) {
+    std::thread printer([chan] {
+        std::vector<OwnedMatch> batch;
+        while (chan->receiveBatch(batch, 64) > 0) {
+            batch.clear();
+        }
+    });
+    for (long f = 0; f < files; ++f) {
+        std::vector<OwnedMatch> matches;
+        for (long i = 0; i < perFile; ++i) {
+            matches.push_back(OwnedMatch{std::this_thread::get_id(), filePath, static_cast<int>(i), line});
+        }
+        chan->sendBatch(std::move(matches));
+    }
+    chan->close();
+    printer.join();
+}
+
+/**
+ * @brief Send files slabs of perFile matches, new ones or from the pool
+ */
+static void sendSlabs(channel<MatchSlab*>* chan, long files, long perFile, bool pooled) {
+    std::thread printer([chan, pooled] {
+        std::vector<MatchSlab*> batch;
+        while (chan->receiveBatch(batch, 64) > 0) {
+            if (pooled) {
+                matchSlabPool().release(batch);
+            } else {
+                for (MatchSlab* slab : batch) delete slab;
+                batch.clear();
+            }
+        }
+    });
+    for (long f = 0; f < files; ++f) {
+        MatchSlab* slab = pooled ? matchSlabPool().acquire() : new MatchSlab();
+        slab->thread_id = std::this_thread::get_id();
+        slab->file_path = filePath;
+        for (long i = 0; i < perFile; ++i) {
+            slab->add(static_cast<int>(i), 0, line.data(), line.data() + line.size());
+        }
+        chan->send(slab);
+    }
+    chan->close();
+    printer.join();
+}
+
+int main(int argc, char* argv[]) {
+    long count = (argc >= 2) ? std::atol(argv[1]) : 200000;
+    long perFile = (argc >= 3) ? std::atol(argv[2]) : 10;
+    if (count < 1) count = 1;
+    if (perFile < 1) perFile = 1;
+    const long files = (count + perFile - 1) / perFile;
+    count = files * perFile;
+
+    struct Setup {
+        const char* name;
+        int size;
+        channelKind kind;
+    };
+    const Setup setups[] = {
+        {"unbuffered", 0, channelKind::locked},
+        {"buffered", 64, channelKind::locked},
+        {"lock-free", 64, channelKind::lockFree},
+    };
+    const char* payloads[] = {"per-line", "slab", "pooled"};
+
+    // Warm the pool so the pooled runs show the steady state
+    channel<MatchSlab*>* warmup = makeChannel<MatchSlab*>(64);
+    sendSlabs(warmup, files, perFile, true);
+    delete warmup;
+
+    std::printf("matches: %ld, per file: %ld\n", count, perFile);
+    std::printf("%-12s %-10s %14s %12s\n", "channel", "payload", "allocs/match", "seconds");
+    for (const Setup& setup : setups) {
+        for (int p = 0; p < 3; ++p) {
+            unsigned long before = allocations.load();
+            auto start = std::chrono::steady_clock::now();
+            if (p == 0) {
+                channel<OwnedMatch>* chan = makeChannel<OwnedMatch>(setup.size, setup.kind);
+                sendOwned(chan, files, perFile);
+                delete chan;
+            } else {
+                channel<MatchSlab*>* chan = makeChannel<MatchSlab*>(setup.size, setup.kind);
+                sendSlabs(chan, files, perFile, p == 2);
+                delete chan;
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            unsigned long allocs = allocations.load() - before;
+            std::printf("%-12s %-10s %14.3f %12.3f\n", setup.name, payloads[p],
+                        static_cast<double>(allocs) / count, elapsed.count());
+        }
+    }
+    return 0;
+}
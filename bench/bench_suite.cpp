@@ -0,0 +1,371 @@
+/**
+ * @file bench/bench_suite.cpp
+ *
+ * @brief The benchmark suite behind make bench, reporting in JSON.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file generates a synthetic tree with generateCorpus() and measures
+ * three things on it:
+ *
+ * - channel: items per second through the unbuffered, buffered and
+ *   lock-free channels with an equal number of senders and receivers, for
+ *   2, 4, ... up to the maximum thread count.
+ * - scan: searchFileForTarget over every file of the corpus on one thread,
+ *   reporting lines, files (-l) and counts (-c), in MB/s and files/s.
+ * - end_to_end: bin/search run on the corpus with a few option sets, timed
+ *   from start to exit with the output thrown away.
+ *
+ * Every measurement is repeated and the fastest run is kept. The results go
+ * to a JSON document with the corpus spec and one flat record per
+ * measurement, identified by group and name, so two runs can be compared
+ * record by record to spot regressions. Progress goes to stderr.
+ *
+ * Usage: bin/bench_suite [--corpus DIR] [--out FILE] [--search BIN]
+ *        [--files N] [--seed N] [--max-threads N] [--repeat N]
+ */
+
+#include "corpus.h"
+#include "channel.h"
+#include "match_pool.h"
+#include "matcher.h"
+#include "search_worker.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class JsonRecord
+ *
+ * @brief One measurement as a flat JSON object
+ */
+class JsonRecord {
+public:
+    JsonRecord(const std::string& group, const std::string& name) {
+        add("group", group);
+        add("name", name);
+    }
+
+    JsonRecord& add(const char* key, const std::string& value) {
+        std::string quoted = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') quoted += '\\';
+            quoted += c;
+        }
+        return raw(key, quoted + "\"");
+    }
+
+    JsonRecord& add(const char* key, double value) {
+        char number[64];
+        std::snprintf(number, sizeof(number), "%.6g", value);
+        return raw(key, number);
+    }
+
+    JsonRecord& add(const char* key, std::uint64_t value) {
+        return raw(key, std::to_string(value));
+    }
+
+    std::string str() const { return "{" + body + "}"; }
+
+private:
+    JsonRecord& raw(const char* key, const std::string& value) {
+        if (!body.empty()) body += ", ";
+        body += "\"" + std::string(key) + "\": " + value;
+        return *this;
+    }
+
+    std::string body;
+};
+
+/**
+ * @brief Seconds of the fastest of several runs of a benchmark
+ */
+template <class Run>
+static double fastest(int repeat, Run run) {
+    double best = 0;
+    for (int r = 0; r < repeat; ++r) {
+        double seconds = run();
+        if (r == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+/**
+ * @brief Move items through a channel with threads/2 senders and the rest receiving
+ *
+ * @return double Seconds taken
+ */
+static double channelRun(int bufferSize, channelKind kind, int threads, long items) {
+    channel<long>* chan = makeChannel<long>(bufferSize, kind);
+    int senders = threads / 2;
+    std::atomic<long> received{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int s = 0; s < senders; ++s) {
+        pool.emplace_back([=] {
+            for (long i = s; i < items; i += senders) {
+                chan->send(i);
+            }
+        });
+    }
+    for (int r = senders; r < threads; ++r) {
+        pool.emplace_back([&] {
+            long value;
+            while (chan->receive(value)) {
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (int s = 0; s < senders; ++s) {
+        pool[s].join();
+    }
+    chan->close();
+    for (std::size_t t = senders; t < pool.size(); ++t) {
+        pool[t].join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (received.load() != items) {
+        std::fprintf(stderr, "lost items: sent %ld, received %ld\n", items, received.load());
+    }
+    delete chan;
+    return elapsed.count();
+}
+
+/**
+ * @brief Search every file once with searchFileForTarget on this thread
+ *
+ * @param matches Set to the matching lines (or summaries) sent
+ *
+ * @return double Seconds taken
+ *
+ * @details A second thread drains the result channel the way the printer
+ * does, so the scan never blocks on a full channel.
+ */
+static double scanRun(const std::vector<std::filesystem::path>& files, const Matcher& matcher,
+                      const ScanLimits& limits, std::uint64_t& matches) {
+    channel<MatchSlab*>* resultChan = makeChannel<MatchSlab*>(64);
+    std::atomic<std::uint64_t> received{0};
+    std::thread drain([&] {
+        std::vector<MatchSlab*> batch;
+        while (resultChan->receiveBatch(batch, PRINTER_BATCH_SIZE) > 0) {
+            for (const MatchSlab* slab : batch) {
+                received.fetch_add(slab->matches.empty() ? 1 : slab->matches.size(), std::memory_order_relaxed);
+            }
+            matchSlabPool().release(batch);
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (const std::filesystem::path& file : files) {
+        searchFileForTarget(file, matcher, limits, resultChan);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    resultChan->close();
+    drain.join();
+    delete resultChan;
+    matches = received.load();
+    return elapsed.count();
+}
+
+/**
+ * @brief Run bin/search once with its output discarded
+ *
+ * @return double Seconds from start to exit, or a negative value if it failed
+ */
+static double searchRun(const std::string& command) {
+    auto start = std::chrono::steady_clock::now();
+    int status = std::system(command.c_str());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return status == 0 ? elapsed.count() : -1.0;
+}
+
+static void usage(const char* prog) {
+    std::fprintf(stderr,
+                 "Usage: %s [--corpus DIR] [--out FILE] [--search BIN] [--files N]\n"
+                 "       [--seed N] [--max-threads N] [--repeat N]\n",
+                 prog);
+}
+
+int main(int argc, char* argv[]) {
+    CorpusSpec spec;
+    std::string corpusDir = "obj/bench-corpus";
+    std::string outPath;
+    std::string searchBin = "bin/search";
+    int maxThreads = static_cast<int>(std::min(16u, std::max(2u, std::thread::hardware_concurrency())));
+    int repeat = 3;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--corpus") {
+            corpusDir = value;
+        } else if (arg == "--out") {
+            outPath = value;
+        } else if (arg == "--search") {
+            searchBin = value;
+        } else if (arg == "--files") {
+            spec.files = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--seed") {
+            spec.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--max-threads") {
+            maxThreads = std::max(2, std::atoi(value));
+        } else if (arg == "--repeat") {
+            repeat = std::max(1, std::atoi(value));
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> records;
+
+    std::fprintf(stderr, "generating corpus in %s\n", corpusDir.c_str());
+    CorpusSummary corpus;
+    try {
+        corpus = generateCorpus(spec, corpusDir);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::fprintf(stderr, "channel throughput\n");
+    struct ChannelSetup {
+        const char* name;
+        int size;
+        channelKind kind;
+        long items;
+    };
+    // Every unbuffered item is a full handshake, so it gets fewer
+    const ChannelSetup channels[] = {
+        {"unbuffered", 0, channelKind::locked, 100000},
+        {"buffered", 64, channelKind::locked, 1000000},
+        {"lock-free", 64, channelKind::lockFree, 1000000},
+    };
+    for (const ChannelSetup& setup : channels) {
+        for (int threads = 2; threads <= maxThreads; threads *= 2) {
+            double seconds = fastest(repeat, [&] {
+                return channelRun(setup.size, setup.kind, threads, setup.items);
+            });
+            records.push_back(JsonRecord("channel", setup.name)
+                .add("threads", static_cast<std::uint64_t>(threads))
+                .add("buffer", static_cast<std::uint64_t>(setup.size))
+                .add("items", static_cast<std::uint64_t>(setup.items))
+                .add("seconds", seconds)
+                .add("items_per_sec", setup.items / seconds)
+                .str());
+        }
+    }
+
+    std::fprintf(stderr, "per-file scan\n");
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(corpusDir)) {
+        if (entry.is_regular_file() && entry.path().filename() != ".bench-corpus") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    std::unique_ptr<Matcher> matcher(makeMatcher({spec.target}));
+    struct ScanSetup {
+        const char* name;
+        reportMode mode;
+    };
+    const ScanSetup scans[] = {
+        {"lines", reportMode::lines},
+        {"files", reportMode::files},
+        {"counts", reportMode::counts},
+    };
+    for (const ScanSetup& setup : scans) {
+        SkipCounts skipped;
+        ScanLimits limits;
+        limits.mode = setup.mode;
+        limits.skipped = &skipped;
+        std::uint64_t matches = 0;
+        double seconds = fastest(repeat, [&] {
+            return scanRun(files, *matcher, limits, matches);
+        });
+        records.push_back(JsonRecord("scan", setup.name)
+            .add("files", static_cast<std::uint64_t>(files.size()))
+            .add("bytes", corpus.bytes)
+            .add("matches", matches)
+            .add("seconds", seconds)
+            .add("mb_per_sec", corpus.bytes / seconds / (1 << 20))
+            .add("files_per_sec", files.size() / seconds)
+            .str());
+    }
+
+    std::fprintf(stderr, "end to end with %s\n", searchBin.c_str());
+    struct SearchSetup {
+        const char* name;
+        const char* options;
+    };
+    const SearchSetup searches[] = {
+        {"default", ""},
+        {"lock-free", "--lock-free"},
+        {"walkers-4", "--walkers 4"},
+        {"fused", "--fused"},
+        {"files-with-matches", "-l"},
+        {"ignore-case", "-i"},
+    };
+    for (const SearchSetup& setup : searches) {
+        std::string command = "\"" + searchBin + "\" --no-index " + setup.options + " "
+            + spec.target + " \"" + corpusDir + "\" > /dev/null";
+        double seconds = fastest(repeat, [&] { return searchRun(command); });
+        if (seconds < 0) {
+            std::fprintf(stderr, "failed: %s\n", command.c_str());
+            continue;
+        }
+        records.push_back(JsonRecord("end_to_end", setup.name)
+            .add("options", setup.options)
+            .add("seconds", seconds)
+            .add("mb_per_sec", corpus.bytes / seconds / (1 << 20))
+            .str());
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"seed\": " << spec.seed << ",\n  \"repeat\": " << repeat
+         << ",\n  \"hardware_threads\": " << std::thread::hardware_concurrency()
+         << ",\n  \"corpus\": {\"files\": " << corpus.files << ", \"binary_files\": " << corpus.binary_files
+         << ", \"directories\": " << corpus.directories << ", \"bytes\": " << corpus.bytes
+         << ", \"hit_lines\": " << corpus.hit_lines << ", \"depth\": " << spec.depth
+         << ", \"fanout\": " << spec.fanout << ", \"min_size\": " << spec.min_size
+         << ", \"max_size\": " << spec.max_size << ", \"sizes\": \""
+         << (spec.sizes == sizeDistribution::uniform ? "uniform" : "skewed")
+         << "\", \"hit_density\": " << spec.hit_density << ", \"binary_fraction\": " << spec.binary_fraction
+         << "},\n  \"results\": [\n";
+    for (std::size_t r = 0; r < records.size(); ++r) {
+        json << "    " << records[r] << (r + 1 < records.size() ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+
+    if (outPath.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream out(outPath);
+        out << json.str();
+        if (!out) {
+            std::fprintf(stderr, "Error writing %s\n", outPath.c_str());
+            return 1;
+        }
+        std::fprintf(stderr, "results written to %s\n", outPath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file bench/channel_bench.cpp
+ *
+ * @brief Throughput benchmark of the locked and lock-free buffered channels.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file pushes a fixed number of integers through a buffered channel
+ * with an equal number of sender and receiver threads, for increasing thread
+ * counts, once with bufferedChannel and once with lockFreeChannel. It prints
+ * the transfer rate of each run so contention at high thread counts can be
+ * compared between the two.
+ *
+ * Usage: bin/channel_bench [items] [buffer size] [max threads]
+ */
+
+#include "channel.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Move items through a channel and time it
+ *
+ * @param kind Which buffered channel to build
+ * @param threads Total threads, half sending and half receiving
+ * @param items Total items to transfer
+ * @param bufferSize The channel buffer size
+ *
+ * @return double Seconds taken
+ */
+static double runOnce(channelKind kind, int threads, long items, int bufferSize) {
+    channel<long>* chan = makeChannel<long>(bufferSize, kind);
+    int senders = threads / 2;
+    int receivers = threads - senders;
+    std::atomic<long> received{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int s = 0; s < senders; ++s) {
+        pool.emplace_back([=] {
+            for (long i = s; i < items; i += senders) {
+                chan->send(i);
+            }
+        });
+    }
+    for (int r = 0; r < receivers; ++r) {
+        pool.emplace_back([&] {
+            long value;
+            while (chan->receive(value)) {
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (int s = 0; s < senders; ++s) {
+        pool[s].join();
+    }
+    chan->close();
+    for (std::size_t t = senders; t < pool.size(); ++t) {
+        pool[t].join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (received.load() != items) {
+        std::fprintf(stderr, "lost items: sent %ld, received %ld\n", items, received.load());
+    }
+    delete chan;
+    return elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    long items = (argc >= 2) ? std::atol(argv[1]) : 2000000;
+    int bufferSize = (argc >= 3) ? std::atoi(argv[2]) : 64;
+    int maxThreads = (argc >= 4) ? std::atoi(argv[3]) : 64;
+    if (items < 1) items = 1;
+    if (bufferSize < 1) bufferSize = 1;
+
+    std::printf("items: %ld, buffer: %d\n", items, bufferSize);
+    std::printf("%-8s %-10s %14s\n", "threads", "channel", "Mitems/s");
+    for (int threads = 2; threads <= maxThreads; threads *= 2) {
+        double locked = runOnce(channelKind::locked, threads, items, bufferSize);
+        std::printf("%-8d %-10s %14.2f\n", threads, "locked", items / locked / 1e6);
+        double lockFree = runOnce(channelKind::lockFree, threads, items, bufferSize);
+        std::printf("%-8d %-10s %14.2f\n", threads, "lock-free", items / lockFree / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file bench/corpus.h
+ *
+ * @brief Deterministic synthetic source trees for the benchmarks.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains CorpusSpec, which describes a synthetic tree to search,
+ * and generateCorpus(), which writes it. Everything is drawn from one
+ * SplitMix64 stream seeded by the spec, and no std:: distribution is used
+ * (their output differs between standard libraries), so the same spec gives
+ * byte-identical trees on every machine and benchmark results stay
+ * comparable between releases. Header only, since each bench/ program is
+ * built from a single source file.
+ */
+
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @enum sizeDistribution
+ *
+ * @brief How file sizes are spread between the smallest and largest size
+ *
+ * @details uniform draws every size equally often; skewed draws the
+ * logarithm of the size uniformly, giving many small files and a few large
+ * ones, the way real source trees look.
+ */
+enum class sizeDistribution { uniform, skewed };
+
+/**
+ * @struct CorpusSpec
+ *
+ * @brief What a synthetic tree looks like
+ *
+ * @var files Number of files
+ * @var depth Directory levels below the root
+ * @var fanout Subdirectories per directory
+ * @var min_size Smallest file in bytes
+ * @var max_size Largest file in bytes
+ * @var sizes How sizes are spread between min_size and max_size
+ * @var hit_density Fraction of lines that contain the target
+ * @var binary_fraction Fraction of files with NUL bytes in their first block
+ * @var seed Seeds everything else
+ * @var target The word planted in hit lines
+ */
+struct CorpusSpec {
+    std::size_t files = 2000;
+    unsigned depth = 3;
+    unsigned fanout = 4;
+    std::size_t min_size = 512;
+    std::size_t max_size = 256 * 1024;
+    sizeDistribution sizes = sizeDistribution::skewed;
+    double hit_density = 0.001;
+    double binary_fraction = 0.02;
+    std::uint64_t seed = 42;
+    std::string target = "needle_token";
+};
+
+/**
+ * @struct CorpusSummary
+ *
+ * @brief What generateCorpus() wrote
+ *
+ * @var files Files written
+ * @var binary_files Files given binary noise
+ * @var directories Directories created, the root included
+ * @var bytes Bytes written
+ * @var hit_lines Lines containing the target, in text files only
+ */
+struct CorpusSummary {
+    std::size_t files = 0;
+    std::size_t binary_files = 0;
+    std::size_t directories = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t hit_lines = 0;
+};
+
+/**
+ * @class CorpusRandom
+ *
+ * @brief SplitMix64, the same sequence on every platform
+ */
+class CorpusRandom {
+public:
+    explicit CorpusRandom(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1)
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Uniform in [0, n)
+    std::size_t below(std::size_t n) { return n ? static_cast<std::size_t>(next() % n) : 0; }
+
+private:
+    std::uint64_t state;
+};
+
+/**
+ * @brief Every directory of a tree with the given depth and fanout, root first
+ */
+inline std::vector<std::filesystem::path> corpusDirectories(const std::filesystem::path& root,
+                                                            unsigned depth, unsigned fanout) {
+    std::vector<std::filesystem::path> dirs{root};
+    std::size_t levelStart = 0;
+    for (unsigned level = 0; level < depth; ++level) {
+        std::size_t levelEnd = dirs.size();
+        for (std::size_t d = levelStart; d < levelEnd; ++d) {
+            for (unsigned f = 0; f < fanout; ++f) {
+                dirs.push_back(dirs[d] / ("d" + std::to_string(level) + "_" + std::to_string(f)));
+            }
+        }
+        levelStart = levelEnd;
+    }
+    return dirs;
+}
+
+/**
+ * @brief Write the tree described by spec under root
+ *
+ * @param spec What to generate
+ * @param root The directory to fill; it is emptied first
+ *
+ * @return CorpusSummary What was written
+ *
+ * @throws std::runtime_error If root is a non-empty directory that was not
+ * written by generateCorpus() (it leaves a ".bench-corpus" marker)
+ *
+ * @details Files are spread round-robin over every directory and get one of
+ * the extensions the search looks at by default. Text lines are made of
+ * words from a fixed vocabulary; a line contains the target with probability
+ * hit_density. A binary file has NUL bytes scattered through its first 8 KiB
+ * so the binary check skips it.
+ */
+inline CorpusSummary generateCorpus(const CorpusSpec& spec, const std::filesystem::path& root) {
+    static const char* const words[] = {
+        "int", "return", "value", "count", "buffer", "index", "static", "const",
+        "while", "for", "if", "else", "struct", "node", "next", "size", "data",
+        "result", "error", "void", "char", "list", "map", "key", "thread", "lock",
+    };
+    static const char* const extensions[] = {".c", ".h", ".cpp", ".hpp", ".py", ".sh", ".txt"};
+    const std::size_t wordCount = sizeof(words) / sizeof(words[0]);
+    const std::size_t extCount = sizeof(extensions) / sizeof(extensions[0]);
+
+    CorpusSummary summary;
+    CorpusRandom rng(spec.seed);
+
+    const std::filesystem::path marker = root / ".bench-corpus";
+    if (std::filesystem::exists(root) && !std::filesystem::is_empty(root)
+        && !std::filesystem::exists(marker)) {
+        throw std::runtime_error("refusing to replace " + root.string() + ", which is not a generated corpus");
+    }
+    std::filesystem::remove_all(root);
+    std::vector<std::filesystem::path> dirs = corpusDirectories(root, spec.depth, spec.fanout);
+    for (const std::filesystem::path& dir : dirs) {
+        std::filesystem::create_directories(dir);
+    }
+    summary.directories = dirs.size();
+    std::ofstream(marker) << spec.seed << '\n';
+
+    const std::size_t minSize = spec.min_size ? spec.min_size : 1;
+    const std::size_t maxSize = spec.max_size > minSize ? spec.max_size : minSize;
+    std::string content;
+    for (std::size_t i = 0; i < spec.files; ++i) {
+        std::size_t size;
+        if (spec.sizes == sizeDistribution::uniform) {
+            size = minSize + rng.below(maxSize - minSize + 1);
+        } else {
+            double lo = std::log(static_cast<double>(minSize));
+            double hi = std::log(static_cast<double>(maxSize));
+            size = static_cast<std::size_t>(std::exp(lo + (hi - lo) * rng.unit()));
+        }
+        bool binary = rng.unit() < spec.binary_fraction;
+
+        content.clear();
+        content.reserve(size + 128);
+        while (content.size() < size) {
+            std::size_t lineEnd = content.size() + 20 + rng.below(80);
+            bool hitLine = rng.unit() < spec.hit_density;
+            bool pending = hitLine;
+            std::size_t hitAt = content.size() + rng.below(60);
+            while (content.size() < lineEnd) {
+                if (pending && content.size() >= hitAt) {
+                    content += spec.target;
+                    pending = false;
+                } else {
+                    content += words[rng.below(wordCount)];
+                }
+                content += ' ';
+            }
+            if (pending) {
+                content += spec.target;
+            }
+            if (hitLine && !binary) {
+                ++summary.hit_lines;
+            }
+            content += '\n';
+        }
+        if (binary) {
+            std::size_t block = content.size() < 8192 ? content.size() : 8192;
+            for (int n = 0; n < 16; ++n) {
+                content[rng.below(block)] = '\0';
+            }
+            ++summary.binary_files;
+        }
+
+        std::filesystem::path file = dirs[i % dirs.size()]
+            / ("f" + std::to_string(i) + extensions[rng.below(extCount)]);
+        std::ofstream out(file, std::ios::binary);
+        out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        summary.bytes += content.size();
+        ++summary.files;
+    }
+    return summary;
+}
+
+#endif // BENCH_CORPUS_H
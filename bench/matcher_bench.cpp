@@ -0,0 +1,243 @@
+/**
+ * @file bench/matcher_bench.cpp
+ *
+ * @brief Microbenchmark of the literal search kernels against std::string::find.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file builds a deterministic buffer of pseudo-random text lines and
+ * counts the occurrences of needles of several lengths in it, once with the
+ * old per-line std::string::find approach and once with each search kernel
+ * the CPU supports operating on the whole buffer. The throughput of each
+ * run is printed in MB/s along with the hit count so the kernels can be
+ * checked against each other. A second table compares searching for many
+ * needles with one literal pass per needle against a single Aho-Corasick
+ * pass for all of them. A third table runs a few regular expressions
+ * through std::regex line by line and through RegexMatcher, with and
+ * without a required literal for the prefilter to look for. A last table
+ * runs one needle through the matcher makeMatcher() builds for each
+ * combination of -i, -w and -v, next to a plain LiteralMatcher, so the
+ * default mode can be checked for regressions.
+ *
+ * Usage: bin/matcher_bench [buffer MiB] [repetitions]
+ */
+
+#include "matcher.h"
+#include "aho_corasick.h"
+#include "regex_matcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Build a buffer of lowercase words separated by spaces and newlines
+ *
+ * @param bytes The size of the buffer
+ *
+ * @return std::string The generated text
+ *
+ * @details A fixed-seed xorshift generator keeps the text identical between
+ * runs so results are comparable.
+ */
+static std::string makeText(std::size_t bytes) {
+    std::string text;
+    text.reserve(bytes);
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+    std::size_t lineLen = 0;
+    while (text.size() < bytes) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        unsigned r = static_cast<unsigned>(state % 32);
+        if (r < 26) {
+            text.push_back(static_cast<char>('a' + r));
+            ++lineLen;
+        } else if (r < 31 || lineLen < 40) {
+            text.push_back(' ');
+            ++lineLen;
+        } else {
+            text.push_back('\n');
+            lineLen = 0;
+        }
+    }
+    return text;
+}
+
+/**
+ * @brief Count hits the way the original worker did: getline-style copies + find
+ */
+static std::size_t countPerLine(const std::string& text, const std::string& needle) {
+    std::size_t hits = 0;
+    std::size_t start = 0;
+    std::string line;
+    while (start < text.size()) {
+        std::size_t nl = text.find('\n', start);
+        if (nl == std::string::npos) nl = text.size();
+        line.assign(text, start, nl - start);
+        if (line.find(needle) != std::string::npos) ++hits;
+        start = nl + 1;
+    }
+    return hits;
+}
+
+/**
+ * @brief Count matching lines with a Matcher over the whole buffer
+ */
+static std::size_t countWithMatcher(const std::string& text, const Matcher& matcher) {
+    std::size_t hits = 0;
+    const char* cursor = text.data();
+    const char* end = cursor + text.size();
+    while (cursor < end) {
+        const char* hit = matcher.find(cursor, end);
+        if (!hit) break;
+        ++hits;
+        const char* nl = static_cast<const char*>(std::memchr(hit, '\n', end - hit));
+        cursor = nl ? nl + 1 : end;
+    }
+    return hits;
+}
+
+template <class F>
+static double timeRuns(int reps, std::size_t& hits, F&& run) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        hits = run();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / reps;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t mib = (argc >= 2) ? std::strtoul(argv[1], nullptr, 10) : 64;
+    int reps = (argc >= 3) ? std::atoi(argv[2]) : 3;
+    if (mib == 0) mib = 1;
+    if (reps < 1) reps = 1;
+
+    std::string text = makeText(mib << 20);
+    const double megabytes = static_cast<double>(text.size()) / (1 << 20);
+
+    // Needles are cut from the text so longer ones still hit
+    const std::size_t lengths[] = {1, 2, 3, 4, 8, 16, 32, 64};
+    const SearchKernel kernels[] = {SearchKernel::Scalar, SearchKernel::SSE2, SearchKernel::AVX2};
+
+    std::printf("buffer: %.0f MiB, repetitions: %d, best kernel: %s\n",
+                megabytes, reps, searchKernelName(bestSearchKernel()));
+    std::printf("%-6s %-12s %12s %10s\n", "len", "engine", "MB/s", "hits");
+
+    for (std::size_t len : lengths) {
+        std::string needle = text.substr(text.size() / 2, len);
+        for (char& c : needle) {
+            if (c == '\n') c = ' ';
+        }
+
+        std::size_t hits = 0;
+        double secs = timeRuns(reps, hits, [&] { return countPerLine(text, needle); });
+        std::printf("%-6zu %-12s %12.1f %10zu\n", len, "std::find", megabytes / secs, hits);
+
+        for (SearchKernel kernel : kernels) {
+            if (!searchKernelSupported(kernel)) continue;
+            LiteralMatcher matcher(needle, kernel);
+            secs = timeRuns(reps, hits, [&] { return countWithMatcher(text, matcher); });
+            std::printf("%-6zu %-12s %12.1f %10zu\n", len, searchKernelName(kernel),
+                        megabytes / secs, hits);
+        }
+    }
+
+    // Many 8-byte needles: one pass each vs one pass for all
+    const std::size_t counts[] = {2, 8, 32, 200};
+    std::printf("\n%-6s %-12s %12s %10s\n", "count", "engine", "MB/s", "hits");
+    for (std::size_t count : counts) {
+        std::vector<std::string> needles;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string needle = text.substr((text.size() / (count + 1)) * (i + 1), 8);
+            for (char& c : needle) {
+                if (c == '\n') c = ' ';
+            }
+            needles.push_back(needle);
+        }
+
+        std::size_t hits = 0;
+        double secs = timeRuns(reps, hits, [&] {
+            std::size_t total = 0;
+            for (const std::string& needle : needles) {
+                total += countWithMatcher(text, LiteralMatcher(needle));
+            }
+            return total;
+        });
+        std::printf("%-6zu %-12s %12.1f %10zu\n", count, "per-needle", megabytes / secs, hits);
+
+        AhoCorasickMatcher multi(needles);
+        secs = timeRuns(reps, hits, [&] { return countWithMatcher(text, multi); });
+        std::printf("%-6zu %-12s %12.1f %10zu\n", count, "aho-corasick", megabytes / secs, hits);
+    }
+
+    // std::regex is slow enough that a slice of the buffer is plenty
+    std::string slice = text.substr(0, std::min<std::size_t>(text.size(), std::size_t(8) << 20));
+    slice.resize(slice.rfind('\n') + 1);
+    const double sliceMegabytes = static_cast<double>(slice.size()) / (1 << 20);
+    const char* regexes[] = {"qu[a-z]+ing", "^[a-f]+ ", "(xz|zx)[a-z]*q", "[aeiou]{4}"};
+    std::printf("\n%-16s %-12s %12s %10s\n", "regex", "engine", "MB/s", "hits");
+    for (const char* pattern : regexes) {
+        std::size_t hits = 0;
+        std::regex re(pattern, std::regex::extended);
+        double secs = timeRuns(1, hits, [&] {
+            std::size_t total = 0;
+            std::size_t start = 0;
+            while (start < slice.size()) {
+                std::size_t nl = slice.find('\n', start);
+                if (std::regex_search(slice.begin() + start, slice.begin() + nl, re)) ++total;
+                start = nl + 1;
+            }
+            return total;
+        });
+        std::printf("%-16s %-12s %12.1f %10zu\n", pattern, "std::regex", sliceMegabytes / secs, hits);
+
+        RegexMatcher matcher({pattern});
+        secs = timeRuns(reps, hits, [&] { return countWithMatcher(slice, matcher); });
+        std::printf("%-16s %-12s %12.1f %10zu\n", pattern,
+                    matcher.requiredLiterals().empty() ? "lazy-dfa" : "prefiltered",
+                    sliceMegabytes / secs, hits);
+    }
+
+    // Matching modes: each combination is its own instantiation
+    std::string needle = text.substr(text.size() / 3, 6);
+    for (char& c : needle) {
+        if (c == '\n') c = ' ';
+    }
+    struct Mode {
+        const char* name;
+        MatchOptions options;
+    };
+    const Mode modes[] = {
+        {"default", {false, false, false}},
+        {"-i", {true, false, false}},
+        {"-w", {false, true, false}},
+        {"-i -w", {true, true, false}},
+        {"-v", {false, false, true}},
+    };
+    std::printf("\n%-16s %-12s %12s %10s\n", "mode", "engine", "MB/s", "hits");
+    {
+        std::size_t hits = 0;
+        LiteralMatcher plain(needle);
+        double secs = timeRuns(reps, hits, [&] { return countWithMatcher(text, plain); });
+        std::printf("%-16s %-12s %12.1f %10zu\n", "(literal)", searchKernelName(plain.kernel()),
+                    megabytes / secs, hits);
+    }
+    for (const Mode& mode : modes) {
+        std::size_t hits = 0;
+        std::unique_ptr<Matcher> matcher(makeMatcher({needle}, patternSyntax::literal, mode.options));
+        double secs = timeRuns(reps, hits, [&] { return countWithMatcher(text, *matcher); });
+        std::printf("%-16s %-12s %12.1f %10zu\n", mode.name, "makeMatcher", megabytes / secs, hits);
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file src/aho_corasick.cpp
+ *
+ * @brief Implementation of the Aho-Corasick multi-pattern matcher.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the construction of the automaton and the scan loop.
+ * The patterns are inserted into a trie whose children live in the same
+ * flat states x classes table that is later used for scanning. A breadth
+ * first pass then computes the failure links and fills every missing
+ * transition with the one of the failure state, which turns the trie into a
+ * complete DFA. A final pass premultiplies the targets and sets the match
+ * flag.
+ */
+
+#include "aho_corasick.h"
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+AhoCorasickMatcher::AhoCorasickMatcher(const std::vector<std::string>& patterns, bool foldCase) {
+    // Byte classes: one per byte used by a pattern, class 0 for the rest
+    std::memset(byteClass, 0, sizeof(byteClass));
+    for (const std::string& pattern : patterns) {
+        for (unsigned char c : pattern) {
+            if (byteClass[c] == 0) {
+                byteClass[c] = static_cast<std::uint16_t>(classes++);
+                if (foldCase && std::isalpha(c)) {
+                    byteClass[c ^ 0x20] = byteClass[c];
+                }
+            }
+        }
+    }
+
+    // Trie; a zero child means "no edge" since the root is never a child
+    std::vector<std::uint32_t> next(classes, 0);
+    output.assign(1, NO_PATTERN);
+    lengths.reserve(patterns.size());
+    for (std::size_t i = 0; i < patterns.size(); ++i) {
+        const std::string& pattern = patterns[i];
+        lengths.push_back(static_cast<std::uint32_t>(pattern.size()));
+        if (pattern.empty()) {
+            if (emptyPattern == NO_PATTERN) emptyPattern = static_cast<std::uint32_t>(i);
+            continue;
+        }
+        std::uint32_t s = 0;
+        for (unsigned char c : pattern) {
+            std::size_t edge = s * classes + byteClass[c];
+            if (next[edge] == 0) {
+                next[edge] = static_cast<std::uint32_t>(states++);
+                next.resize(states * classes, 0);
+                output.push_back(NO_PATTERN);
+            }
+            s = next[edge];
+        }
+        if (output[s] == NO_PATTERN) {
+            output[s] = static_cast<std::uint32_t>(i); // duplicates keep the first index
+        }
+    }
+    if (states * classes >= MATCH_FLAG) {
+        throw std::length_error("AhoCorasickMatcher: automaton too large");
+    }
+
+    // Breadth-first: failure links, inherited outputs, and the missing edges
+    std::vector<std::uint32_t> fail(states, 0);
+    std::vector<std::uint32_t> queue;
+    queue.reserve(states);
+    for (std::size_t c = 0; c < classes; ++c) {
+        std::uint32_t child = next[c];
+        if (child != 0) {
+            queue.push_back(child);
+        }
+    }
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        std::uint32_t s = queue[head];
+        std::uint32_t f = fail[s];
+        // A longer pattern ending here takes precedence over its suffixes
+        if (output[s] == NO_PATTERN) {
+            output[s] = output[f];
+        }
+        for (std::size_t c = 0; c < classes; ++c) {
+            std::uint32_t& child = next[s * classes + c];
+            if (child != 0) {
+                fail[child] = next[f * classes + c];
+                queue.push_back(child);
+            } else {
+                child = next[f * classes + c];
+            }
+        }
+    }
+
+    // Premultiply targets and flag the ones that end a pattern
+    table.resize(states * classes);
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        std::uint32_t target = next[i];
+        table[i] = target * static_cast<std::uint32_t>(classes)
+                 | (output[target] != NO_PATTERN ? MATCH_FLAG : 0);
+    }
+}
+
+const char* AhoCorasickMatcher::find(const char* begin, const char* end) const {
+    std::size_t pattern;
+    return findPattern(begin, end, pattern);
+}
+
+const char* AhoCorasickMatcher::findPattern(const char* begin, const char* end, std::size_t& pattern) const {
+    if (emptyPattern != NO_PATTERN) {
+        pattern = emptyPattern;
+        return begin;
+    }
+    const std::uint32_t* t = table.data();
+    std::uint32_t s = 0;
+    for (const char* p = begin; p < end; ++p) {
+        s = t[s + byteClass[static_cast<unsigned char>(*p)]];
+        if (s & MATCH_FLAG) {
+            std::uint32_t hit = output[(s & ~MATCH_FLAG) / classes];
+            pattern = hit;
+            return p + 1 - lengths[hit];
+        }
+    }
+    return nullptr;
+}
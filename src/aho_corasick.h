@@ -0,0 +1,64 @@
+/**
+ * @file src/aho_corasick.h
+ *
+ * @brief Declaration of the Aho-Corasick multi-pattern matcher.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of AhoCorasickMatcher, which finds the
+ * first occurrence of any of a set of literal patterns in a single pass over
+ * the bytes, however many patterns there are. The automaton is compiled into
+ * a complete DFA stored as one flat transition table.
+ */
+
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "matcher.h"
+
+/**
+ * @class AhoCorasickMatcher
+ *
+ * @brief Matcher for a set of literal patterns
+ *
+ * @details Bytes are first mapped to byte classes: every byte that occurs in
+ * some pattern gets its own class and all other bytes share class 0, so a
+ * row of the table is only as wide as the pattern alphabet. Each table entry
+ * holds the target state already multiplied by the row width, with the top
+ * bit set when the target state ends a pattern, so the inner loop is one
+ * load and one test per byte. find() reports the pattern that ends first;
+ * when several end at the same byte, the longest one wins. An empty pattern
+ * matches at the start of any range. With foldCase both cases of an ASCII
+ * letter share one byte class, so ignoring case costs nothing per byte.
+ */
+class AhoCorasickMatcher final : public Matcher {
+public:
+    explicit AhoCorasickMatcher(const std::vector<std::string>& patterns, bool foldCase = false);
+
+    const char* find(const char* begin, const char* end) const override;
+    const char* findPattern(const char* begin, const char* end, std::size_t& pattern) const override;
+
+    std::size_t stateCount() const { return states; }
+    std::size_t classCount() const { return classes; }
+
+private:
+    static constexpr std::uint32_t MATCH_FLAG = 0x80000000u;
+    static constexpr std::uint32_t NO_PATTERN = 0xffffffffu;
+
+    std::uint16_t byteClass[256];
+    std::size_t classes = 1;
+    std::size_t states = 1;
+    std::vector<std::uint32_t> table;     // states x classes, premultiplied targets
+    std::vector<std::uint32_t> output;    // pattern ending at each state, or NO_PATTERN
+    std::vector<std::uint32_t> lengths;   // length of each pattern
+    std::uint32_t emptyPattern = NO_PATTERN;
+};
+
+#endif // AHO_CORASICK_H
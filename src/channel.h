@@ -11,6 +11,111 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+//Clock used for timed receives
+typedef std::chrono::steady_clock channelClock;
+
+/*
+	Channel metrics, only recorded when
+	built with CHANNEL_STATS defined
+	(make CHANNEL_STATS=1). Otherwise every
+	hook is empty and stats() is all zero.
+ */
+#ifdef CHANNEL_STATS
+constexpr bool channelStatsEnabled = true;
+#else
+constexpr bool channelStatsEnabled = false;
+#endif
+
+//Buckets of the depth histogram:
+//0, 1, 2-3, 4-7, ... and the rest in the last
+constexpr std::size_t CHANNEL_DEPTH_BUCKETS = 12;
+
+//What a channel has seen so far
+struct channelStats{
+	//False if the channel keeps no metrics
+	bool recorded = false;
+	//Items sent through the channel
+	std::uint64_t transferred = 0;
+	//Items already queued when each item was sent
+	std::uint64_t depthHistogram[CHANNEL_DEPTH_BUCKETS] = {};
+	//Sends that found no room (or no receiver)
+	std::uint64_t senderWaits = 0;
+	channelClock::duration senderWaitTime{0};
+	//Receives that found nothing to take
+	std::uint64_t receiverWaits = 0;
+	channelClock::duration receiverWaitTime{0};
+};
+
+//Bucket of the depth histogram for a depth
+inline std::size_t channelDepthBucket(std::size_t depth){
+	std::size_t bucket=0;
+	while(depth > 0 && bucket+1 < CHANNEL_DEPTH_BUCKETS){
+		depth >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+//Records channelStats, always under
+//the owning channel's lock
+class channelMeter{
+	public:
+#ifdef CHANNEL_STATS
+		//One item sent with depth items queued
+		void item(std::size_t depth){
+			data.transferred++;
+			data.depthHistogram[channelDepthBucket(depth)]++;
+		}
+		//Start timing a wait if we will block
+		channelClock::time_point start(bool blocked) const{
+			return blocked ? channelClock::now() : channelClock::time_point();
+		}
+		void senderWaited(channelClock::time_point since){
+			if(since != channelClock::time_point()){
+				data.senderWaits++;
+				data.senderWaitTime += channelClock::now()-since;
+			}
+		}
+		void receiverWaited(channelClock::time_point since){
+			if(since != channelClock::time_point()){
+				data.receiverWaits++;
+				data.receiverWaitTime += channelClock::now()-since;
+			}
+		}
+		channelStats get() const{
+			return data;
+		}
+	private:
+		channelStats data = recordedStats();
+		static channelStats recordedStats(){
+			channelStats fresh;
+			fresh.recorded = true;
+			return fresh;
+		}
+#else
+		void item(std::size_t){}
+		channelClock::time_point start(bool) const{
+			return channelClock::time_point();
+		}
+		void senderWaited(channelClock::time_point){}
+		void receiverWaited(channelClock::time_point){}
+		channelStats get() const{
+			return channelStats();
+		}
+#endif
+};
 
 //Generic Channel
 template <class X>
@@ -18,16 +123,66 @@ class channel{
 	public:
 		//Destructor
 		virtual ~channel(){};
-		//Send a Message
-		virtual void send(X value)=0;
+		//Send a Message (copied)
+		virtual void send(const X& value)=0;
+		//Send a Message (moved in)
+		virtual void send(X&& value)=0;
+		//Build a Message and send it
+		template <class... Args>
+		void emplace(Args&&... args){
+			send(X(std::forward<Args>(args)...));
+		}
 		//Recieve a Message
+		//throws if the channel is closed
 		virtual X receive()=0;
+		//Recieve a Message
+		//false once closed and empty
+		virtual bool receive(X& value)=0;
+		//Recieve only if a Message is ready now
+		virtual std::optional<X> tryReceive()=0;
+		//Recieve, giving up after timeout
+		//false on timeout or once closed and empty
+		//(use isClosed to tell them apart)
+		virtual bool receiveFor(X& value,
+			channelClock::duration timeout)=0;
+		//Send many Messages in order
+		virtual void sendBatch(const std::vector<X>& values)=0;
+		//Same, moving out of values
+		//(values is left with moved-from items)
+		virtual void sendBatch(std::vector<X>&& values)=0;
+		//Send as many Messages as fit right now
+		//from the front of values, removing them
+		//returns how many (never blocks)
+		virtual std::size_t trySendBatch(std::vector<X>& values)=0;
+		//Recieve between 1 and maxItems Messages
+		//appended to out, returns how many
+		//0 once closed and empty
+		virtual std::size_t receiveBatch(
+			std::vector<X>& out, std::size_t maxItems)=0;
 		//Close the Channel
 		virtual void close()=0;
 		//Check if closed
 		virtual bool isClosed()=0;
+		//Metrics so far (see CHANNEL_STATS)
+		//Channels that keep none return zeros
+		virtual channelStats stats(){
+			return channelStats();
+		}
 };
 
+//Wait on a condition until a deadline
+//channelClock::time_point::max() waits forever
+template <class Pred>
+bool channelWait(std::condition_variable& cv,
+	std::unique_lock<std::mutex>& lk,
+	channelClock::time_point deadline, Pred pred){
+	if(deadline==channelClock::time_point::max()){
+		cv.wait(lk, pred);
+		return true;
+	}
+	return cv.wait_until(lk, deadline, pred);
+}
+
 /*
 	Unbuffered channels sync both threads
 	the send must complete before either
@@ -41,25 +196,60 @@ class unbufferedChannel: public channel<X>{
 		//Communication Space
 		bool senderReady;
 		bool receiverReady;
-		//Place Holder
-		X tempVal;
+		//Only one sender and one receiver
+		//use the handshake at a time
+		bool sending;
+		bool receiving;
+		//Values left in the current sender's batch
+		std::size_t batchLeft;
+		//The value being handed over, one of
+		//these points into the sender's stack
+		X* moveFrom;
+		const X* copyFrom;
 		//Mutex and condition for communication
 		mutable std::mutex cMut;
 		std::condition_variable sender;
 		std::condition_variable receiver;
+		//Metrics, guarded by cMut
+		channelMeter meter;
+		//One handshake (lock held, side claimed)
+		template <class V>
+		void handOff(std::unique_lock<std::mutex>& lk, V&& value);
+		template <class It>
+		void sendRange(It first, It last);
+		bool takeOne(std::unique_lock<std::mutex>& lk, X& value,
+			channelClock::time_point deadline);
+		//Claim/release the sender or receiver side
+		void claimSender(std::unique_lock<std::mutex>& lk);
+		void releaseSender();
+		bool claimReceiver(std::unique_lock<std::mutex>& lk,
+			channelClock::time_point deadline);
+		void releaseReceiver();
 	public:
 		//Constructor
 		unbufferedChannel();
 		//Destructor
 		~unbufferedChannel();
 		//Send a Message
-		void send(X value);
+		void send(const X& value);
+		void send(X&& value);
 		//Recieve a Message
 		X receive();
+		bool receive(X& value);
+		std::optional<X> tryReceive();
+		bool receiveFor(X& value, channelClock::duration timeout);
+		//Send many Messages
+		void sendBatch(const std::vector<X>& values);
+		void sendBatch(std::vector<X>&& values);
+		std::size_t trySendBatch(std::vector<X>& values);
+		//Recieve up to maxItems Messages
+		std::size_t receiveBatch(std::vector<X>& out, std::size_t maxItems);
 		//Close the Channel
 		void close();
 		//Check if closed
 		bool isClosed();
+		//Metrics so far
+		channelStats stats();
 };
 
 /*
@@ -73,11 +263,18 @@ class bufferedChannel: public channel<X>{
 		bool open;
 		//Buffer is a queue
 		std::queue<X>* buffer;
-		int maxSize;
+		std::size_t maxSize;
 		//Safety
 		mutable std::mutex buffMut;
 		std::condition_variable sender;
 		std::condition_variable receiver;
+		//Metrics, guarded by buffMut
+		channelMeter meter;
+		//Shared by the copy and move versions
+		template <class V>
+		void put(V&& value);
+		template <class It>
+		void putRange(It first, It last);
 	public:
 		//Constructor
 		bufferedChannel();
@@ -85,24 +282,124 @@ class bufferedChannel: public channel<X>{
 		bufferedChannel(int size);
 		//Destructor
 		~bufferedChannel();
+		//Build a Message directly in the buffer
+		template <class... Args>
+		void emplace(Args&&... args);
 		//Send a Message
-		void send(X value);
+		void send(const X& value);
+		void send(X&& value);
 		//Recieve a Message
 		X receive();
+		bool receive(X& value);
+		std::optional<X> tryReceive();
+		bool receiveFor(X& value, channelClock::duration timeout);
+		//Send many Messages
+		void sendBatch(const std::vector<X>& values);
+		void sendBatch(std::vector<X>&& values);
+		std::size_t trySendBatch(std::vector<X>& values);
+		//Recieve up to maxItems Messages
+		std::size_t receiveBatch(std::vector<X>& out, std::size_t maxItems);
 		//Close the Channel
 		void close();
 		//Check if closed
 		bool isClosed();
+		//Metrics so far
+		channelStats stats();
+};
+
+/*
+	Lock Free Channels are bounded ring
+	buffers. Senders and receivers claim
+	slots with atomics and only take a lock
+	to sleep when the ring is full or empty.
+	close() must happen after every send
+	has returned.
+ */
+template <class X>
+class lockFreeChannel: public channel<X>{
+	private:
+		//One slot of the ring
+		//sequence tells whose turn it is
+		struct cell{
+			std::atomic<std::size_t> sequence;
+			X data;
+		};
+		//The ring (capacity is a power of 2)
+		cell* ring;
+		std::size_t mask;
+		//Keep the two ends on separate cache lines
+		alignas(64) std::atomic<std::size_t> head;
+		alignas(64) std::atomic<std::size_t> tail;
+		alignas(64) std::atomic<bool> open;
+		//Parking for full/empty
+		std::atomic<int> parkedSenders;
+		std::atomic<int> parkedReceivers;
+		std::mutex parkMut;
+		std::condition_variable sender;
+		std::condition_variable receiver;
+		//Attempts before parking
+		static const int SPIN_TRIES = 16;
+		//Helpers
+		template <class V>
+		bool tryPush(V&& value);
+		template <class V>
+		void put(V&& value);
+		template <class It>
+		void putRange(It first, It last);
+		bool tryPop(X& value);
+		bool isEmpty() const;
+		bool isFull() const;
+		void wakeSender(bool all=false);
+		void wakeReceiver(bool all=false);
+		//Spin then park until there is room
+		void waitForRoom();
+		//Spin then park until there is data
+		//false if closed and drained or past deadline
+		bool waitForData(channelClock::time_point deadline);
+	public:
+		//Constructor
+		lockFreeChannel(int size);
+		//Destructor
+		~lockFreeChannel();
+		//Send a Message
+		void send(const X& value);
+		void send(X&& value);
+		//Recieve a Message
+		X receive();
+		bool receive(X& value);
+		std::optional<X> tryReceive();
+		bool receiveFor(X& value, channelClock::duration timeout);
+		//Send many Messages
+		void sendBatch(const std::vector<X>& values);
+		void sendBatch(std::vector<X>&& values);
+		std::size_t trySendBatch(std::vector<X>& values);
+		//Recieve up to maxItems Messages
+		std::size_t receiveBatch(std::vector<X>& out, std::size_t maxItems);
+		//Close the Channel
+		void close();
+		//Check if closed
+		bool isClosed();
+		//No metrics: counters shared by both
+		//ends would undo the point of the ring
 };
 
 /*--------------------------------------*/
 /*       Make Channel Function          */
 /*--------------------------------------*/
+//Which buffered implementation to build
+enum class channelKind{
+	locked,
+	lockFree
+};
+
 template <class X>
-channel<X>* makeChannel(int size=0){
+channel<X>* makeChannel(int size=0, channelKind kind=channelKind::locked){
 	if(size==0){
 		return new unbufferedChannel<X>();
 	}
+	if(kind==channelKind::lockFree){
+		return new lockFreeChannel<X>(size);
+	}
 	return new bufferedChannel<X>(size);
 }
 
@@ -117,6 +414,11 @@ unbufferedChannel<X>::unbufferedChannel(){
 	//We have not done anything
 	senderReady = false;
 	receiverReady = false;
+	sending = false;
+	receiving = false;
+	batchLeft = 0;
+	moveFrom = nullptr;
+	copyFrom = nullptr;
 }
 
 //Destructor has nothing interesting to do
@@ -124,18 +426,61 @@ template <class X>
 unbufferedChannel<X>::~unbufferedChannel(){
 }
 
-//Send a message
+//Wait our turn as the sender
 template <class X>
-void unbufferedChannel<X>::send(X value){
-	std::unique_lock<std::mutex> lk(cMut);
-	if(!open){
-		throw std::runtime_error(
-			"Send on Closed Channel.");
+void unbufferedChannel<X>::claimSender(std::unique_lock<std::mutex>& lk){
+	sender.wait(lk,[this]{
+		return !sending;});
+	sending=true;
+}
+
+template <class X>
+void unbufferedChannel<X>::releaseSender(){
+	sending=false;
+	sender.notify_all();
+}
+
+//Wait our turn as the receiver
+//false if closed or out of time
+template <class X>
+bool unbufferedChannel<X>::claimReceiver(
+	std::unique_lock<std::mutex>& lk,
+	channelClock::time_point deadline){
+	bool ready = channelWait(receiver, lk, deadline, [this]{
+		return !receiving || !open;});
+	if(!ready || !open){
+		return false;
 	}
+	receiving=true;
+	return true;
+}
+
+template <class X>
+void unbufferedChannel<X>::releaseReceiver(){
+	receiving=false;
+	receiver.notify_all();
+}
+
+//Give one value to the receiver
+//The receiver copies or moves straight
+//out of the sender's value
+template <class X>
+template <class V>
+void unbufferedChannel<X>::handOff(
+	std::unique_lock<std::mutex>& lk, V&& value){
 	//Wait on a receiver
+	channelClock::time_point since = meter.start(!receiverReady);
 	sender.wait(lk,[this]{
 		return receiverReady;});
-	tempVal = value;
+	meter.senderWaited(since);
+	meter.item(0);
+	if constexpr(std::is_rvalue_reference<V&&>::value){
+		moveFrom = &value;
+		copyFrom = nullptr;
+	}else{
+		moveFrom = nullptr;
+		copyFrom = &value;
+	}
 	senderReady=true;
 	receiver.notify_all();
 	//Wait until picked up
@@ -146,35 +491,174 @@ void unbufferedChannel<X>::send(X value){
 	receiver.notify_all();
 }
 
-//Receive a message
+//Take one value from the sender
+//false if the channel closed first
+//or no sender showed up in time
 template <class X>
-X unbufferedChannel<X>::receive(){
-	std::unique_lock<std::mutex> lk(cMut);
-	if(!open){
-		throw std::runtime_error(
-			"Receive on Closed Channel.");
-	}
+bool unbufferedChannel<X>::takeOne(
+	std::unique_lock<std::mutex>& lk, X& value,
+	channelClock::time_point deadline){
 	//Wait on something to receive
 	receiverReady=true;
 	sender.notify_all();
 	//Release lock so sender can act
-	receiver.wait(lk,[this]{
+	channelClock::time_point since = meter.start(!senderReady && open);
+	channelWait(receiver, lk, deadline, [this]{
 		return senderReady || !open;});
-	//Waiting on a channel that is closed
-	if(!open){
-		throw std::runtime_error(
-			"Receive on Closed Channel.");
+	meter.receiverWaited(since);
+	//Closed or timed out before a sender came
+	if(!senderReady){
+		receiverReady=false;
+		return false;
 	}
 	//Get value
-	X myVal = tempVal;
+	if(moveFrom){
+		value = std::move(*moveFrom);
+	}else{
+		value = *copyFrom;
+	}
+	moveFrom = nullptr;
+	copyFrom = nullptr;
 	receiverReady=false;
 	sender.notify_all();
 	//Make sure they cleared out
 	receiver.wait(lk,[this]{
 		return !senderReady;});
+	return true;
+}
+
+//Send a message
+template <class X>
+void unbufferedChannel<X>::send(const X& value){
+	sendRange(&value, &value+1);
+}
+
+template <class X>
+void unbufferedChannel<X>::send(X&& value){
+	sendRange(std::make_move_iterator(&value),
+		std::make_move_iterator(&value+1));
+}
+
+//Receive a message
+template <class X>
+X unbufferedChannel<X>::receive(){
+	X myVal;
+	if(!receive(myVal)){
+		throw std::runtime_error(
+			"Receive on Closed Channel.");
+	}
 	return myVal;
 }
 
+//Receive a message without throwing
+template <class X>
+bool unbufferedChannel<X>::receive(X& value){
+	std::unique_lock<std::mutex> lk(cMut);
+	if(!claimReceiver(lk, channelClock::time_point::max())){
+		return false;
+	}
+	bool got = takeOne(lk, value, channelClock::time_point::max());
+	releaseReceiver();
+	return got;
+}
+
+//Receive only if a sender is already waiting
+template <class X>
+std::optional<X> unbufferedChannel<X>::tryReceive(){
+	std::unique_lock<std::mutex> lk(cMut);
+	if(!open || receiving || !sending){
+		return std::nullopt;
+	}
+	receiving=true;
+	X myVal;
+	bool got = takeOne(lk, myVal, channelClock::time_point::max());
+	releaseReceiver();
+	if(!got){
+		return std::nullopt;
+	}
+	return myVal;
+}
+
+//Receive a message or give up
+template <class X>
+bool unbufferedChannel<X>::receiveFor(X& value,
+	channelClock::duration timeout){
+	channelClock::time_point deadline = channelClock::now() + timeout;
+	std::unique_lock<std::mutex> lk(cMut);
+	if(!claimReceiver(lk, deadline)){
+		return false;
+	}
+	bool got = takeOne(lk, value, deadline);
+	releaseReceiver();
+	return got;
+}
+
+//Send many messages
+//Each value is still a full handshake
+//but we keep the sender side the whole time
+template <class X>
+template <class It>
+void unbufferedChannel<X>::sendRange(It first, It last){
+	std::unique_lock<std::mutex> lk(cMut);
+	if(!open){
+		throw std::runtime_error(
+			"Send on Closed Channel.");
+	}
+	claimSender(lk);
+	for(; first != last; ++first){
+		batchLeft = static_cast<std::size_t>(std::distance(first, last))-1;
+		handOff(lk, *first);
+	}
+	releaseSender();
+}
+
+template <class X>
+void unbufferedChannel<X>::sendBatch(const std::vector<X>& values){
+	sendRange(values.begin(), values.end());
+}
+
+template <class X>
+void unbufferedChannel<X>::sendBatch(std::vector<X>&& values){
+	sendRange(std::make_move_iterator(values.begin()),
+		std::make_move_iterator(values.end()));
+}
+
+//A handoff always waits for the receiver
+//so there is never room without blocking
+template <class X>
+std::size_t unbufferedChannel<X>::trySendBatch(std::vector<X>&){
+	std::lock_guard<std::mutex> lk(cMut);
+	if(!open){
+		throw std::runtime_error(
+			"Send on Closed Channel.");
+	}
+	return 0;
+}
+
+//Receive many messages
+//Blocks for the first, then keeps taking
+//while the sender still has a batch going
+template <class X>
+std::size_t unbufferedChannel<X>::receiveBatch(
+	std::vector<X>& out, std::size_t maxItems){
+	std::unique_lock<std::mutex> lk(cMut);
+	if(!claimReceiver(lk, channelClock::time_point::max())){
+		return 0;
+	}
+	std::size_t count=0;
+	X myVal;
+	while(count < maxItems
+		&& takeOne(lk, myVal, channelClock::time_point::max())){
+		out.push_back(std::move(myVal));
+		count++;
+		if(batchLeft==0){
+			break;
+		}
+	}
+	releaseReceiver();
+	return count;
+}
+
 
 //Close the Channel
 template <class X>
@@ -190,6 +674,13 @@ bool unbufferedChannel<X>::isClosed(){
 	return !open;
 }
 
+//Metrics so far
+template <class X>
+channelStats unbufferedChannel<X>::stats(){
+	std::lock_guard<std::mutex> lk(cMut);
+	return meter.get();
+}
+
 /*--------------------------------------*/
 /* Implementation of Buffered Template  */
 /*--------------------------------------*/
@@ -205,7 +696,7 @@ bufferedChannel<X>::bufferedChannel(){
 template <class X>
 bufferedChannel<X>::bufferedChannel(int size){
 	open=true;
-	maxSize = size;
+	maxSize = static_cast<std::size_t>(size);
 	buffer = new std::queue<X>();
 }
 
@@ -231,49 +722,563 @@ bool bufferedChannel<X>::isClosed(){
 	return (!open && buffer->size()==0);
 }
 
+//Metrics so far
+template <class X>
+channelStats bufferedChannel<X>::stats(){
+	std::lock_guard<std::mutex> lk(buffMut);
+	return meter.get();
+}
+
 //Send a Message
 template <class X>
-void bufferedChannel<X>::send(X value){
+template <class V>
+void bufferedChannel<X>::put(V&& value){
 	std::unique_lock<std::mutex> lk(buffMut);
 	//We cannot send if closed
 	if(!open){
 		throw std::runtime_error(
-			"Receive on Closed Channel.");
+			"Send on Closed Channel.");
 	}
 	//Wait if the buffer is full
+	channelClock::time_point since = meter.start(!(buffer->size() < maxSize));
 	sender.wait(lk,[this]{
 		return buffer->size() < maxSize;});
+	meter.senderWaited(since);
 	//Add to queue
-	buffer->push(value);
+	meter.item(buffer->size());
+	buffer->push(std::forward<V>(value));
 	//Mission Accomplished!
 	receiver.notify_one();
 	return;
 }
 
+template <class X>
+void bufferedChannel<X>::send(const X& value){
+	put(value);
+}
+
+template <class X>
+void bufferedChannel<X>::send(X&& value){
+	put(std::move(value));
+}
+
+//Build the Message in the queue itself
+template <class X>
+template <class... Args>
+void bufferedChannel<X>::emplace(Args&&... args){
+	std::unique_lock<std::mutex> lk(buffMut);
+	if(!open){
+		throw std::runtime_error(
+			"Send on Closed Channel.");
+	}
+	channelClock::time_point since = meter.start(!(buffer->size() < maxSize));
+	sender.wait(lk,[this]{
+		return buffer->size() < maxSize;});
+	meter.senderWaited(since);
+	meter.item(buffer->size());
+	buffer->emplace(std::forward<Args>(args)...);
+	receiver.notify_one();
+}
+
 //Recieve a Message
 template <class X>
 X bufferedChannel<X>::receive(){
-	std::unique_lock<std::mutex> lk(buffMut);
-	//We cannot receive if closed
-	if(!open && buffer->size()==0){
+	X data;
+	if(!receive(data)){
 		throw std::runtime_error(
 			"Receive on Closed Channel.");
 	}
+	return data;
+}
+
+//Recieve a Message without throwing
+template <class X>
+bool bufferedChannel<X>::receive(X& value){
+	std::unique_lock<std::mutex> lk(buffMut);
 	//Wait for data
+	channelClock::time_point since = meter.start(buffer->size()==0 && open);
 	receiver.wait(lk,[this]{
 		return buffer->size()>0 || !open;});
+	meter.receiverWaited(since);
 	//We might be waiting when a close happens
-	if(!open && buffer->size()==0){
-		throw std::runtime_error(
-			"Receive on Closed Channel.");
+	if(buffer->size()==0){
+		return false;
 	}
 	//Get data
-	X data = buffer->front();
+	value = std::move(buffer->front());
 	buffer->pop();
 	//Release
 	sender.notify_one();
-	//Return value
+	return true;
+}
+
+//Recieve only if something is buffered
+template <class X>
+std::optional<X> bufferedChannel<X>::tryReceive(){
+	std::lock_guard<std::mutex> lk(buffMut);
+	if(buffer->size()==0){
+		return std::nullopt;
+	}
+	std::optional<X> data(std::move(buffer->front()));
+	buffer->pop();
+	sender.notify_one();
 	return data;
 }
 
+//Recieve a Message or give up
+template <class X>
+bool bufferedChannel<X>::receiveFor(X& value,
+	channelClock::duration timeout){
+	std::unique_lock<std::mutex> lk(buffMut);
+	channelClock::time_point since = meter.start(buffer->size()==0 && open);
+	receiver.wait_for(lk, timeout, [this]{
+		return buffer->size()>0 || !open;});
+	meter.receiverWaited(since);
+	//Timed out or closed and empty
+	if(buffer->size()==0){
+		return false;
+	}
+	value = std::move(buffer->front());
+	buffer->pop();
+	sender.notify_one();
+	return true;
+}
+
+//Send many Messages
+//One lock for the whole batch unless
+//we have to wait for room
+template <class X>
+template <class It>
+void bufferedChannel<X>::putRange(It first, It last){
+	std::unique_lock<std::mutex> lk(buffMut);
+	//We cannot send if closed
+	if(!open){
+		throw std::runtime_error(
+			"Send on Closed Channel.");
+	}
+	while(first != last){
+		//Wait if the buffer is full
+		channelClock::time_point since = meter.start(!(buffer->size() < maxSize));
+		sender.wait(lk,[this]{
+			return buffer->size() < maxSize;});
+		meter.senderWaited(since);
+		//Fill as much as fits
+		while(first != last && buffer->size() < maxSize){
+			meter.item(buffer->size());
+			buffer->push(*first);
+			++first;
+		}
+		//Wake everyone who can take something
+		receiver.notify_all();
+	}
+}
+
+template <class X>
+void bufferedChannel<X>::sendBatch(const std::vector<X>& values){
+	putRange(values.begin(), values.end());
+}
+
+template <class X>
+void bufferedChannel<X>::sendBatch(std::vector<X>&& values){
+	putRange(std::make_move_iterator(values.begin()),
+		std::make_move_iterator(values.end()));
+}
+
+//Fill what fits without waiting
+template <class X>
+std::size_t bufferedChannel<X>::trySendBatch(std::vector<X>& values){
+	std::unique_lock<std::mutex> lk(buffMut);
+	if(!open){
+		throw std::runtime_error(
+			"Send on Closed Channel.");
+	}
+	std::size_t count=0;
+	while(count < values.size() && buffer->size() < maxSize){
+		meter.item(buffer->size());
+		buffer->push(std::move(values[count]));
+		count++;
+	}
+	if(count > 0){
+		receiver.notify_all();
+	}
+	values.erase(values.begin(), values.begin()+count);
+	return count;
+}
+
+//Recieve many Messages
+template <class X>
+std::size_t bufferedChannel<X>::receiveBatch(
+	std::vector<X>& out, std::size_t maxItems){
+	std::unique_lock<std::mutex> lk(buffMut);
+	//Wait for data
+	channelClock::time_point since = meter.start(buffer->size()==0 && open);
+	receiver.wait(lk,[this]{
+		return buffer->size()>0 || !open;});
+	meter.receiverWaited(since);
+	//Closed and nothing left
+	if(buffer->size()==0){
+		return 0;
+	}
+	//Take as much as is there
+	std::size_t count=0;
+	while(count < maxItems && buffer->size()>0){
+		out.push_back(std::move(buffer->front()));
+		buffer->pop();
+		count++;
+	}
+	//Room for everyone we took
+	sender.notify_all();
+	return count;
+}
+
+/*--------------------------------------*/
+/* Implementation of Lock Free Template */
+/*--------------------------------------*/
+//Constructor
+template <class X>
+lockFreeChannel<X>::lockFreeChannel(int size){
+	//Round up to a power of 2 so we can mask
+	std::size_t capacity = 2;
+	while(capacity < static_cast<std::size_t>(size)){
+		capacity <<= 1;
+	}
+	ring = new cell[capacity];
+	mask = capacity-1;
+	//Slot i is free for the sender at position i
+	for(std::size_t i=0; i < capacity; i++){
+		ring[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	head.store(0, std::memory_order_relaxed);
+	tail.store(0, std::memory_order_relaxed);
+	open.store(true);
+	parkedSenders.store(0);
+	parkedReceivers.store(0);
+}
+
+//Destructor
+template <class X>
+lockFreeChannel<X>::~lockFreeChannel(){
+	delete[] ring;
+}
+
+//Claim the next free slot, false if full
+//value is only consumed on success
+template <class X>
+template <class V>
+bool lockFreeChannel<X>::tryPush(V&& value){
+	std::size_t pos = head.load(std::memory_order_relaxed);
+	cell* c;
+	while(true){
+		c = &ring[pos & mask];
+		std::size_t seq = c->sequence.load(std::memory_order_acquire);
+		std::intptr_t dif = static_cast<std::intptr_t>(seq)
+			- static_cast<std::intptr_t>(pos);
+		if(dif==0){
+			//Slot is ours if nobody beat us to it
+			if(head.compare_exchange_weak(pos, pos+1,
+				std::memory_order_relaxed)){
+				break;
+			}
+		}else if(dif < 0){
+			//Receivers have not emptied it yet
+			return false;
+		}else{
+			pos = head.load(std::memory_order_relaxed);
+		}
+	}
+	c->data = std::forward<V>(value);
+	//Publish to receivers
+	c->sequence.store(pos+1, std::memory_order_release);
+	return true;
+}
+
+//Claim the next full slot, false if empty
+template <class X>
+bool lockFreeChannel<X>::tryPop(X& value){
+	std::size_t pos = tail.load(std::memory_order_relaxed);
+	cell* c;
+	while(true){
+		c = &ring[pos & mask];
+		std::size_t seq = c->sequence.load(std::memory_order_acquire);
+		std::intptr_t dif = static_cast<std::intptr_t>(seq)
+			- static_cast<std::intptr_t>(pos+1);
+		if(dif==0){
+			if(tail.compare_exchange_weak(pos, pos+1,
+				std::memory_order_relaxed)){
+				break;
+			}
+		}else if(dif < 0){
+			//Nothing published here yet
+			return false;
+		}else{
+			pos = tail.load(std::memory_order_relaxed);
+		}
+	}
+	value = std::move(c->data);
+	//Hand the slot to the sender one lap ahead
+	c->sequence.store(pos+mask+1, std::memory_order_release);
+	return true;
+}
+
+//Approximate checks used while parked
+template <class X>
+bool lockFreeChannel<X>::isEmpty() const{
+	std::size_t pos = tail.load(std::memory_order_seq_cst);
+	std::size_t seq = ring[pos & mask].sequence.load(std::memory_order_seq_cst);
+	return seq != pos+1;
+}
+
+template <class X>
+bool lockFreeChannel<X>::isFull() const{
+	std::size_t pos = head.load(std::memory_order_seq_cst);
+	std::size_t seq = ring[pos & mask].sequence.load(std::memory_order_seq_cst);
+	return seq != pos;
+}
+
+//Only touch the lock if someone is asleep
+template <class X>
+void lockFreeChannel<X>::wakeReceiver(bool all){
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(parkedReceivers.load(std::memory_order_relaxed) > 0){
+		std::lock_guard<std::mutex> lk(parkMut);
+		if(all){
+			receiver.notify_all();
+		}else{
+			receiver.notify_one();
+		}
+	}
+}
+
+template <class X>
+void lockFreeChannel<X>::wakeSender(bool all){
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(parkedSenders.load(std::memory_order_relaxed) > 0){
+		std::lock_guard<std::mutex> lk(parkMut);
+		if(all){
+			sender.notify_all();
+		}else{
+			sender.notify_one();
+		}
+	}
+}
+
+//Wait for a free slot
+template <class X>
+void lockFreeChannel<X>::waitForRoom(){
+	for(int spin=0; spin < SPIN_TRIES; spin++){
+		if(!isFull() || !open.load()){
+			return;
+		}
+		std::this_thread::yield();
+	}
+	//Full, sleep until a receiver frees a slot
+	std::unique_lock<std::mutex> lk(parkMut);
+	parkedSenders.fetch_add(1);
+	sender.wait(lk,[this]{
+		return !isFull() || !open.load();});
+	parkedSenders.fetch_sub(1);
+}
+
+//Wait for a published slot
+template <class X>
+bool lockFreeChannel<X>::waitForData(channelClock::time_point deadline){
+	for(int spin=0; spin < SPIN_TRIES; spin++){
+		if(!isEmpty()){
+			return true;
+		}
+		if(!open.load()){
+			break;
+		}
+		std::this_thread::yield();
+	}
+	if(!open.load()){
+		//Closed, but a last item may still be there
+		return !isEmpty();
+	}
+	//Empty, sleep until a sender publishes
+	std::unique_lock<std::mutex> lk(parkMut);
+	parkedReceivers.fetch_add(1);
+	channelWait(receiver, lk, deadline, [this]{
+		return !isEmpty() || !open.load();});
+	parkedReceivers.fetch_sub(1);
+	return !isEmpty();
+}
+
+//Send a Message
+template <class X>
+template <class V>
+void lockFreeChannel<X>::put(V&& value){
+	while(true){
+		//We cannot send if closed
+		if(!open.load()){
+			throw std::runtime_error(
+				"Send on Closed Channel.");
+		}
+		if(tryPush(std::forward<V>(value))){
+			wakeReceiver();
+			return;
+		}
+		waitForRoom();
+	}
+}
+
+template <class X>
+void lockFreeChannel<X>::send(const X& value){
+	put(value);
+}
+
+template <class X>
+void lockFreeChannel<X>::send(X&& value){
+	put(std::move(value));
+}
+
+//Recieve a Message
+template <class X>
+X lockFreeChannel<X>::receive(){
+	X data;
+	if(!receive(data)){
+		throw std::runtime_error(
+			"Receive on Closed Channel.");
+	}
+	return data;
+}
+
+//Recieve a Message without throwing
+template <class X>
+bool lockFreeChannel<X>::receive(X& value){
+	while(true){
+		if(tryPop(value)){
+			wakeSender();
+			return true;
+		}
+		if(!waitForData(channelClock::time_point::max())){
+			return false;
+		}
+	}
+}
+
+//Recieve only if something is published
+template <class X>
+std::optional<X> lockFreeChannel<X>::tryReceive(){
+	X data;
+	if(!tryPop(data)){
+		return std::nullopt;
+	}
+	wakeSender();
+	return data;
+}
+
+//Recieve a Message or give up
+template <class X>
+bool lockFreeChannel<X>::receiveFor(X& value,
+	channelClock::duration timeout){
+	channelClock::time_point deadline = channelClock::now() + timeout;
+	while(true){
+		if(tryPop(value)){
+			wakeSender();
+			return true;
+		}
+		if(channelClock::now() >= deadline || !waitForData(deadline)){
+			//One last look in case it arrived at the deadline
+			if(tryPop(value)){
+				wakeSender();
+				return true;
+			}
+			return false;
+		}
+	}
+}
+
+//Send many Messages
+//Publish as many as fit, then wake
+//receivers once for all of them
+template <class X>
+template <class It>
+void lockFreeChannel<X>::putRange(It first, It last){
+	while(first != last){
+		//We cannot send if closed
+		if(!open.load()){
+			throw std::runtime_error(
+				"Send on Closed Channel.");
+		}
+		std::size_t pushed=0;
+		while(first != last && tryPush(*first)){
+			++first;
+			pushed++;
+		}
+		if(pushed > 0){
+			wakeReceiver(pushed > 1);
+		}
+		if(first != last){
+			waitForRoom();
+		}
+	}
+}
+
+template <class X>
+void lockFreeChannel<X>::sendBatch(const std::vector<X>& values){
+	putRange(values.begin(), values.end());
+}
+
+template <class X>
+void lockFreeChannel<X>::sendBatch(std::vector<X>&& values){
+	putRange(std::make_move_iterator(values.begin()),
+		std::make_move_iterator(values.end()));
+}
+
+//Publish what fits without waiting
+template <class X>
+std::size_t lockFreeChannel<X>::trySendBatch(std::vector<X>& values){
+	if(!open.load()){
+		throw std::runtime_error(
+			"Send on Closed Channel.");
+	}
+	std::size_t count=0;
+	while(count < values.size() && tryPush(std::move(values[count]))){
+		count++;
+	}
+	if(count > 0){
+		wakeReceiver(count > 1);
+	}
+	values.erase(values.begin(), values.begin()+count);
+	return count;
+}
+
+//Recieve many Messages
+template <class X>
+std::size_t lockFreeChannel<X>::receiveBatch(
+	std::vector<X>& out, std::size_t maxItems){
+	X data;
+	while(true){
+		std::size_t count=0;
+		while(count < maxItems && tryPop(data)){
+			out.push_back(std::move(data));
+			count++;
+		}
+		if(count > 0){
+			wakeSender(count > 1);
+			return count;
+		}
+		if(!waitForData(channelClock::time_point::max())){
+			return 0;
+		}
+	}
+}
+
+//Close the Channel
+template <class X>
+void lockFreeChannel<X>::close(){
+	std::lock_guard<std::mutex> lk(parkMut);
+	open.store(false);
+	receiver.notify_all();
+	sender.notify_all();
+}
+
+//Check if closed
+template <class X>
+bool lockFreeChannel<X>::isClosed(){
+	//Not truly closed till empty
+	return !open.load() && isEmpty();
+}
+
 #endif
@@ -0,0 +1,317 @@
+/**
+ * @file src/file_buffer.cpp
+ *
+ * @brief Implementation of the mmap-backed FileBuffer with a block-read fallback.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of FileBuffer. Regular, non-empty
+ * files are mapped read-only with a sequential access hint. When mmap is not
+ * available for a file the contents are pulled in with read() one BLOCK_SIZE
+ * block at a time into an owned vector, or, for one chunk of a large file,
+ * only the part of the file that chunk needs is read with pread(). Scans of a mapped file run under a
+ * SIGBUS handler that jumps back out of the scan if the file was truncated.
+ */
+
+#include "file_buffer.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <csetjmp>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+// Where the calling thread's innermost read() resumes after a SIGBUS, if inside one
+static thread_local sigjmp_buf* readResume = nullptr;
+
+/**
+ * @brief Leave a guarded scan that touched a page past the end of a truncated file
+ *
+ * @details Outside read() the fault is a real crash, so the default action
+ * is restored and the signal raised again.
+ */
+static void onBusError(int sig, siginfo_t*, void*) {
+    if (readResume) {
+        siglongjmp(*readResume, 1);
+    }
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+
+static void installBusHandler() {
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_sigaction = onBusError;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGBUS, &action, nullptr);
+}
+
+/**
+ * @brief Open and map (or read) the whole file
+ *
+ * @param filePath The path of the file to load
+ * @param map Map the file if possible; false always reads it
+ *
+ * @details On any failure to open the file, isOpen() returns false and the
+ * buffer is empty. An empty file is reported as open with size zero.
+ */
+FileBuffer::FileBuffer(const std::filesystem::path& filePath, bool map) {
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return; // Could not open file due to permissions or other issues
+    }
+
+    // Fallback for files that cannot be mapped
+    opened = (map && mapWhole(fd)) || readBlocks(fd);
+    ::close(fd);
+}
+
+/**
+ * @brief Open one chunk of a file
+ *
+ * @param filePath The path of the file
+ * @param offset Where the chunk starts
+ * @param length How long the chunk is
+ *
+ * @details The whole file is mapped if possible. Otherwise the buffer holds
+ * the byte before the chunk, the chunk, and the rest of the line running past
+ * its end, which is what a chunk search looks at.
+ */
+FileBuffer::FileBuffer(const std::filesystem::path& filePath, std::uintmax_t offset, std::uintmax_t length) {
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    opened = mapWhole(fd) || readChunk(fd, offset, length);
+    ::close(fd);
+}
+
+/**
+ * @brief Take over the bytes of a file that was read elsewhere
+ *
+ * @param contents The whole file
+ */
+FileBuffer::FileBuffer(std::vector<char>&& contents) : opened(true), owned(std::move(contents)) {
+    bytes = owned.data();
+    length = owned.size();
+}
+
+/**
+ * @brief Whether the file looks like binary data rather than text
+ *
+ * @return true if a NUL byte occurs in the first SNIFF_SIZE bytes
+ *
+ * @details NUL never appears in ASCII or UTF-8 text, but is common in
+ * executables, object files, images and archives. Text in UTF-16 or UTF-32
+ * has a NUL in nearly every ASCII character and is also reported as binary.
+ * A buffer holding only a chunk further in was given the answer when it was read.
+ */
+bool FileBuffer::looksBinary() const {
+    if (start > 0) {
+        return binaryStart;
+    }
+    std::size_t n = length < SNIFF_SIZE ? length : SNIFF_SIZE;
+    return n > 0 && std::memchr(bytes, '\0', n) != nullptr;
+}
+
+/**
+ * @brief Run a scan of a mapped buffer with SIGBUS turned into a return of false
+ *
+ * @param scan Calls the scan with context
+ * @param context The scan's state
+ *
+ * @return true if the scan finished, false if it touched a page the file no longer has
+ *
+ * @details The signal mask is saved with the jump buffer, so SIGBUS is
+ * unblocked again after the jump. Nested calls restore the outer guard.
+ */
+bool FileBuffer::readMapped(void (*scan)(void*), void* context) {
+    static std::once_flag installed;
+    std::call_once(installed, installBusHandler);
+
+    sigjmp_buf resume;
+    sigjmp_buf* outer = readResume;
+    if (sigsetjmp(resume, 1) != 0) {
+        readResume = outer;
+        return false;
+    }
+    readResume = &resume;
+    scan(context);
+    readResume = outer;
+    return true;
+}
+
+FileBuffer::~FileBuffer() {
+    release();
+}
+
+FileBuffer::FileBuffer(FileBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+FileBuffer& FileBuffer::operator=(FileBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        opened = other.opened;
+        mapped = other.mapped;
+        length = other.length;
+        start = other.start;
+        binaryStart = other.binaryStart;
+        owned = std::move(other.owned);
+        bytes = mapped ? other.bytes : owned.data();
+        other.opened = false;
+        other.mapped = nullptr;
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief Unmap or free whatever backs the buffer
+ */
+void FileBuffer::release() {
+    if (mapped) {
+        ::munmap(mapped, length);
+        mapped = nullptr;
+    }
+    owned.clear();
+    bytes = nullptr;
+    length = 0;
+    start = 0;
+    binaryStart = false;
+    opened = false;
+}
+
+/**
+ * @brief Map a regular, non-empty file whole
+ *
+ * @param fd An open file descriptor
+ *
+ * @return true if the file was mapped
+ */
+bool FileBuffer::mapWhole(int fd) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+        return false;
+    }
+    void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    mapped = p;
+    bytes = static_cast<const char*>(p);
+    length = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+/**
+ * @brief Read the file into the owned buffer in BLOCK_SIZE pieces
+ *
+ * @param fd An open file descriptor positioned at the start of the file
+ *
+ * @return true if the whole file was read, false on a read error
+ */
+bool FileBuffer::readBlocks(int fd) {
+    std::size_t used = 0;
+    while (true) {
+        if (owned.size() - used < BLOCK_SIZE) {
+            owned.resize(used + BLOCK_SIZE);
+        }
+        ssize_t n = ::read(fd, owned.data() + used, BLOCK_SIZE);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            owned.clear();
+            return false;
+        }
+        if (n == 0) break;
+        used += static_cast<std::size_t>(n);
+    }
+    owned.resize(used);
+    bytes = owned.data();
+    length = used;
+    return true;
+}
+
+/**
+ * @brief Read up to n bytes at a file offset, stopping early only at the end of the file
+ *
+ * @return The number of bytes read, or -1 on a read error
+ */
+static ssize_t readAt(int fd, char* out, std::size_t n, std::uintmax_t at) {
+    std::size_t got = 0;
+    while (got < n) {
+        ssize_t r = ::pread(fd, out + got, n - got, static_cast<off_t>(at + got));
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) break;
+        got += static_cast<std::size_t>(r);
+    }
+    return static_cast<ssize_t>(got);
+}
+
+/**
+ * @brief Read the bytes one chunk of the file needs into the owned buffer
+ *
+ * @param fd An open file descriptor
+ * @param offset Where the chunk starts
+ * @param chunkLength How long the chunk is
+ *
+ * @return true if the bytes were read, false on a read error
+ *
+ * @details The byte before the chunk tells whether the chunk starts a line.
+ * After the chunk, SNIFF_SIZE pieces are read until one holds a newline or
+ * the file ends, and the buffer is cut just past that newline. The start of
+ * the file is sniffed separately so looksBinary() still describes the file.
+ */
+bool FileBuffer::readChunk(int fd, std::uintmax_t offset, std::uintmax_t chunkLength) {
+    start = offset > 0 ? offset - 1 : 0;
+    if (start > 0) {
+        char head[SNIFF_SIZE];
+        ssize_t n = readAt(fd, head, SNIFF_SIZE, 0);
+        if (n < 0) {
+            return false;
+        }
+        binaryStart = std::memchr(head, '\0', static_cast<std::size_t>(n)) != nullptr;
+    }
+
+    owned.resize(static_cast<std::size_t>(offset + chunkLength - start));
+    ssize_t n = readAt(fd, owned.data(), owned.size(), start);
+    if (n < 0) {
+        owned.clear();
+        return false;
+    }
+    std::size_t used = static_cast<std::size_t>(n);
+    if (used == owned.size() && owned.back() != '\n') {
+        while (true) {
+            owned.resize(used + SNIFF_SIZE);
+            n = readAt(fd, owned.data() + used, SNIFF_SIZE, start + used);
+            if (n < 0) {
+                owned.clear();
+                return false;
+            }
+            const void* nl = std::memchr(owned.data() + used, '\n', static_cast<std::size_t>(n));
+            if (nl) {
+                used = static_cast<std::size_t>(static_cast<const char*>(nl) - owned.data()) + 1;
+                break;
+            }
+            used += static_cast<std::size_t>(n);
+            if (static_cast<std::size_t>(n) < SNIFF_SIZE) break;
+        }
+    }
+    owned.resize(used);
+    bytes = owned.data();
+    length = used;
+    return true;
+}
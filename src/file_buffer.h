@@ -0,0 +1,109 @@
+/**
+ * @file src/file_buffer.h
+ *
+ * @brief Declaration of a read-only, whole-file byte buffer backed by mmap
+ *        with a block-read fallback.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of the FileBuffer class, which exposes
+ * the full contents of a file as one contiguous range of bytes. The file is
+ * memory-mapped when possible so no copy is made; files that cannot be mapped
+ * (pipes, special files, filesystems without mmap support) are read into an
+ * owned buffer in large fixed-size blocks instead. Reads of a mapped file go
+ * through read(), which survives the file being truncated underneath it.
+ */
+
+#ifndef FILE_BUFFER_H
+#define FILE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/**
+ * @class FileBuffer
+ *
+ * @brief Read-only view of an entire file's bytes
+ *
+ * @details The constructor opens the file and either maps it or reads it in
+ * blocks of BLOCK_SIZE bytes. isOpen() reports whether either path succeeded.
+ * The buffer is not null terminated; always use data() together with size().
+ * With map set to false the file is always read, so the bytes are in memory
+ * once the constructor returns; a FileBuffer can also take over bytes read
+ * elsewhere (see read_ahead.h). FileBuffer is move-only since it owns the
+ * mapping. looksBinary() only
+ * reads the first SNIFF_SIZE bytes, so on a mapped file it faults in a
+ * couple of pages rather than the whole file.
+ *
+ * A chunk of a large file is opened with an offset and a length. The file is
+ * still mapped whole when it can be; otherwise only the bytes that chunk
+ * needs are read, so the chunks of a file that cannot be mapped do not each
+ * read all of it. offset() is where data() starts in the file, and
+ * looksBinary() still answers for the start of the file.
+ *
+ * If another process truncates a file while it is mapped, touching a page
+ * past the new end raises SIGBUS. read() runs a scan of the buffer with
+ * SIGBUS caught for the calling thread and returns false if it was raised,
+ * so the caller can skip the file. A scan cut short this way is left with
+ * siglongjmp, without unwinding, so while it touches the bytes it may only
+ * load them and store into memory that already exists: no object with a
+ * destructor may be live in the frames it leaves, and no lock held. Callers
+ * collect what they find in plain arrays and build their results outside
+ * read().
+ */
+class FileBuffer {
+public:
+    // Size of each read() when the file cannot be mapped
+    static constexpr std::size_t BLOCK_SIZE = 1 << 20;
+    // Bytes at the start of the file looked at to decide whether it is binary
+    static constexpr std::size_t SNIFF_SIZE = 8 << 10;
+
+    explicit FileBuffer(const std::filesystem::path& filePath, bool map = true);
+    FileBuffer(const std::filesystem::path& filePath, std::uintmax_t offset, std::uintmax_t length);
+    explicit FileBuffer(std::vector<char>&& contents);
+    ~FileBuffer();
+
+    FileBuffer(const FileBuffer&) = delete;
+    FileBuffer& operator=(const FileBuffer&) = delete;
+    FileBuffer(FileBuffer&& other) noexcept;
+    FileBuffer& operator=(FileBuffer&& other) noexcept;
+
+    bool isOpen() const { return opened; }
+    bool isMapped() const { return mapped != nullptr; }
+    const char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+    std::uintmax_t offset() const { return start; }
+    bool looksBinary() const;
+
+    // Run scan(), which reads the buffer; false if the file shrank under the mapping
+    template <class Scan>
+    bool read(Scan scan) const {
+        if (!mapped) {
+            scan();
+            return true;
+        }
+        return readMapped([](void* context) { (*static_cast<Scan*>(context))(); }, &scan);
+    }
+
+private:
+    static bool readMapped(void (*scan)(void*), void* context);
+    void release();
+    bool mapWhole(int fd);
+    bool readBlocks(int fd);
+    bool readChunk(int fd, std::uintmax_t offset, std::uintmax_t chunkLength);
+
+    bool opened = false;
+    void* mapped = nullptr;
+    const char* bytes = nullptr;
+    std::size_t length = 0;
+    std::uintmax_t start = 0;
+    bool binaryStart = false;
+    std::vector<char> owned;
+};
+
+#endif // FILE_BUFFER_H
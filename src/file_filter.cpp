@@ -0,0 +1,28 @@
+/**
+ * @file src/file_filter.cpp
+ *
+ * @brief Implementation of the per-file check made while walking the tree.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ */
+
+#include "file_filter.h"
+
+bool FileFilter::mustSearch(const std::filesystem::directory_entry& entry) const {
+    if (maxFileSize > 0) {
+        std::error_code ec;
+        std::uintmax_t size = entry.file_size(ec);
+        if (!ec && size > maxFileSize) {
+            if (skipped) skipped->too_large.fetch_add(1);
+            return false;
+        }
+    }
+    if (manifest && manifest->checkFile(entry.path())) {
+        return false; // matches are replayed from the manifest
+    }
+    if (index && !index->mustSearch(entry)) {
+        return false;
+    }
+    return true;
+}
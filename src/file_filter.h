@@ -0,0 +1,69 @@
+/**
+ * @file src/file_filter.h
+ *
+ * @brief Declaration of the per-file check made while walking the tree.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of FileFilter, which the producer, the
+ * parallel walker and the fused engine ask about every file with a valid
+ * extension before handing it to a worker. It combines the optional sources
+ * of "this file does not need to be read": a size limit, a manifest that
+ * already holds the file's matches and a trigram index that rules the file
+ * out. SkipCounts tallies the files left unsearched for their size here and
+ * for their content by the workers.
+ */
+
+#ifndef FILE_FILTER_H
+#define FILE_FILTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include "manifest.h"
+#include "trigram_index.h"
+
+/**
+ * @struct SkipCounts
+ *
+ * @brief Files that were walked but not searched because of their size or content
+ *
+ * @var too_large Files over the size limit; these are never opened
+ * @var binary Files whose first block looked binary
+ */
+struct SkipCounts {
+    std::atomic<std::uint64_t> too_large{0};
+    std::atomic<std::uint64_t> binary{0};
+};
+
+/**
+ * @class FileFilter
+ *
+ * @brief Decides whether a walked file must be searched
+ *
+ * @details Files larger than maxFileSize bytes (0 = no limit) are dropped
+ * first, from the size the directory walk already has, and counted in
+ * skipped. The manifest is asked next so that every other walked file is
+ * recorded in it, including files the index then rules out (those are
+ * remembered as having no matches). Every part is optional; a default
+ * FileFilter lets every file through.
+ */
+class FileFilter {
+public:
+    FileFilter(const IndexQuery* index = nullptr, Manifest* manifest = nullptr,
+               std::uintmax_t maxFileSize = 0, SkipCounts* skipped = nullptr)
+        : index(index), manifest(manifest), maxFileSize(maxFileSize), skipped(skipped) {}
+
+    bool mustSearch(const std::filesystem::directory_entry& entry) const;
+
+private:
+    const IndexQuery* index;
+    Manifest* manifest;
+    std::uintmax_t maxFileSize;
+    SkipCounts* skipped;
+};
+
+#endif // FILE_FILTER_H
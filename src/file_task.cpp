@@ -0,0 +1,43 @@
+/**
+ * @file src/file_task.cpp
+ *
+ * @brief Implementation of splitting files into search tasks.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of appendFileTasks, which the
+ * producer and the parallel walker use to turn each file they find into
+ * work items for the search workers.
+ */
+
+#include "file_task.h"
+
+void appendFileTasks(
+    const std::filesystem::path& path,
+    std::uintmax_t size,
+    std::vector<FileTask>& out,
+    std::uint64_t sequence
+) {
+    FileTask task;
+    task.path = path;
+    task.file_size = size;
+    task.sequence = sequence;
+
+    if (size <= SPLIT_CHUNK_SIZE) {
+        task.length = size;
+        out.push_back(std::move(task));
+        return;
+    }
+
+    std::size_t chunks = static_cast<std::size_t>((size + SPLIT_CHUNK_SIZE - 1) / SPLIT_CHUNK_SIZE);
+    task.split = std::make_shared<SplitFile>(chunks);
+    for (std::size_t i = 0; i < chunks; ++i) {
+        task.chunk_index = i;
+        task.offset = i * SPLIT_CHUNK_SIZE;
+        task.length = (i + 1 == chunks) ? size - task.offset : SPLIT_CHUNK_SIZE;
+        out.push_back(task);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file src/file_task.h
+ *
+ * @brief Declaration of the work items sent from the producer to the workers.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of FileTask, the unit of work on the
+ * file channel, and SplitFile, the state shared by the tasks that together
+ * cover one large file. Every task carries the file size seen during the walk.
+ * Files larger than SPLIT_CHUNK_SIZE are cut into byte-range chunks so that
+ * several workers can search one large file at the same time.
+ */
+
+#ifndef FILE_TASK_H
+#define FILE_TASK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "file_buffer.h"
+#include "match.h"
+
+// Files larger than this are split into chunks of this many bytes
+constexpr std::uintmax_t SPLIT_CHUNK_SIZE = std::uintmax_t(8) << 20;
+
+/**
+ * @struct SplitFile
+ *
+ * @brief Shared state for the chunks of one large file
+ *
+ * @var chunk_count Number of chunks the file was cut into
+ * @var mut Guards everything below
+ * @var newline_counts Newlines in each chunk's byte range
+ * @var chunk_slabs Matches found in each chunk, numbered from the chunk start (nullptr if none)
+ * @var hits Matching lines counted so far when only a summary is reported
+ * @var chunks_done How many chunks have reported back
+ *
+ * @details A chunk cannot know its absolute line numbers on its own since
+ * they depend on the newlines in all earlier chunks. Each chunk therefore
+ * reports its newline count and its chunk-relative matches here, and the
+ * worker that finishes the last chunk turns them into absolute line numbers.
+ * When only a count is wanted chunks just add to hits, and a chunk that
+ * starts after the limit was reached does not search at all.
+ */
+struct SplitFile {
+    explicit SplitFile(std::size_t chunks)
+        : chunk_count(chunks), newline_counts(chunks, 0), chunk_slabs(chunks, nullptr) {}
+
+    const std::size_t chunk_count;
+    std::mutex mut;
+    std::vector<std::uint64_t> newline_counts;
+    std::vector<MatchSlab*> chunk_slabs;
+    std::size_t hits = 0;
+    std::size_t chunks_done = 0;
+};
+
+/**
+ * @struct FileTask
+ *
+ * @brief One unit of work for a search worker
+ *
+ * @var path The file to search
+ * @var file_size Size of the file when it was walked
+ * @var offset First byte of the range to search
+ * @var length Number of bytes in the range
+ * @var chunk_index Which chunk of a split file this is
+ * @var split Shared chunk state, null when the task covers the whole file
+ * @var contents The whole file, when the read-ahead stage already read it; null otherwise
+ * @var sequence The file's place in traversal order with --sort (shared by its chunks), NO_SEQUENCE otherwise
+ *
+ * @details A chunk owns every line that starts inside its byte range, even if
+ * the line runs past the end of the range.
+ */
+struct FileTask {
+    std::filesystem::path path;
+    std::uintmax_t file_size = 0;
+    std::uintmax_t offset = 0;
+    std::uintmax_t length = 0;
+    std::size_t chunk_index = 0;
+    std::shared_ptr<SplitFile> split;
+    std::shared_ptr<const FileBuffer> contents;
+    std::uint64_t sequence = NO_SEQUENCE;
+};
+
+/**
+ * @brief Turn one file into one or more tasks
+ *
+ * @param path The file to search
+ * @param size The file size seen during the walk
+ * @param out The tasks are appended here
+ * @param sequence The file's number in traversal order, or NO_SEQUENCE
+ *
+ * @return void
+ *
+ * @details Files up to SPLIT_CHUNK_SIZE become a single whole-file task.
+ * Larger files become one task per SPLIT_CHUNK_SIZE chunk sharing a SplitFile.
+ */
+void appendFileTasks(
+    const std::filesystem::path& path,
+    std::uintmax_t size,
+    std::vector<FileTask>& out,
+    std::uint64_t sequence = NO_SEQUENCE
+);
+
+#endif // FILE_TASK_H
@@ -0,0 +1,118 @@
+/**
+ * @file src/fused_search.cpp
+ *
+ * @brief Implementation of the fused walk-and-search execution engine.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of fusedSearch. The pool threads
+ * run a TreeWalk (see tree_walk.h) whose tasks are either a directory to
+ * list or a FileTask to search, so large files are split into chunk tasks
+ * exactly as the producer splits them, and their chunks are spread over the
+ * pool by stealing.
+ */
+
+#include "fused_search.h"
+#include "file_task.h"
+#include "search_stats.h"
+#include "thread_pool.h"
+#include "tree_walk.h"
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct FusedTask
+ *
+ * @brief One unit of work in the fused engine
+ *
+ * @var file The file or chunk to search, or for a directory just its path
+ * @var is_directory true for a directory, false for a file
+ * @var scope For a directory, the .gitignore scope of its parent
+ */
+struct FusedTask {
+    FileTask file;
+    bool is_directory = false;
+    WalkRules::Scope scope;
+};
+
+/**
+ * @brief Body of one fused pool thread
+ *
+ * @details Listing a directory pushes its subdirectories and the tasks of its
+ * files (one per file, or one per chunk of a large file) onto the calling
+ * thread's own deque.
+ */
+static void fusedLoop(
+    TreeWalk<FusedTask>& walk,
+    unsigned int self,
+    const WalkRules& rules,
+    const FileFilter* filter,
+    channel<MatchSlab*>* resultChan,
+    const Matcher& matcher,
+    const ScanLimits& limits
+) {
+    StatsScope statsScope("fused");
+    std::vector<FileTask> fileTasks;
+    auto onDirectory = [&](const std::filesystem::path& path, const WalkRules::Scope& scope) {
+        FusedTask task;
+        task.file.path = path;
+        task.is_directory = true;
+        task.scope = scope;
+        walk.push(self, std::move(task));
+    };
+    auto onFile = [&](const std::filesystem::directory_entry& entry) {
+        std::error_code sizeEc;
+        std::uintmax_t size = entry.file_size(sizeEc);
+        appendFileTasks(entry.path(), sizeEc ? 0 : size, fileTasks);
+        for (FileTask& file : fileTasks) {
+            FusedTask task;
+            task.file = std::move(file);
+            walk.push(self, std::move(task));
+        }
+        fileTasks.clear();
+    };
+
+    walk.run(self, [&](const FusedTask& task) {
+        if (!task.is_directory) {
+            runFileTask(task.file, matcher, limits, resultChan);
+            return;
+        }
+        try {
+            listWalkDirectory(rules, filter, task.file.path, task.scope, onDirectory, onFile);
+        } catch (const std::exception& e) {
+            std::cerr << "Error during directory traversal: " << e.what() << std::endl;
+        }
+    }, [] {});
+}
+
+void fusedSearch(
+    const std::filesystem::path& rootDir,
+    channel<MatchSlab*>* resultChan,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    const CpuTopology& topology,
+    const PoolSettings& poolSettings,
+    const WalkRules& rules,
+    const FileFilter* filter
+) {
+    // Each thread owns a deque, so the pool keeps its size
+    PoolSettings settings = poolSettings;
+    settings.adaptive = false;
+    if (settings.threads == 0) settings.threads = 1;
+
+    TreeWalk<FusedTask> walk(settings.threads);
+    FusedTask root;
+    root.file.path = rootDir;
+    root.is_directory = true;
+    walk.push(0, std::move(root));
+
+    ThreadPool pool(topology, settings);
+    pool.start([&](PoolWorker& worker) {
+        fusedLoop(walk, worker.index(), rules, filter, resultChan, matcher, limits);
+    });
+    pool.join();
+}
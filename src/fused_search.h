@@ -0,0 +1,63 @@
+/**
+ * @file src/fused_search.h
+ *
+ * @brief Declaration of the fused walk-and-search execution engine.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of fusedSearch, an alternative to the
+ * producer -> file channel -> workers pipeline. Every pool thread both walks
+ * and searches: it owns a deque holding directories still to list and files
+ * still to search, works through it locally, and only steals from its peers
+ * when it runs out. File paths therefore never pass through a shared queue;
+ * only matches go through the result channel to the printer.
+ */
+
+#ifndef FUSED_SEARCH_H
+#define FUSED_SEARCH_H
+
+#include <filesystem>
+#include "channel.h"
+#include "matcher.h"
+#include "search_worker.h"
+#include "thread_pool.h"
+#include "file_filter.h"
+#include "walk_rules.h"
+
+/**
+ * @brief Walk and search a directory tree with one pool of threads
+ *
+ * @param rootDir The root directory to start traversal
+ * @param resultChan The channel to send match slabs through
+ * @param matcher The matcher for the target string
+ * @param limits When to stop searching a file and what to report
+ * @param topology The CPUs and NUMA nodes to place the threads on
+ * @param poolSettings Number of threads and how to pin them; never resized
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Files this rules out are not searched; nullptr searches every file
+ *
+ * @return void
+ *
+ * @details This function starts poolSettings.threads threads in a ThreadPool,
+ * each with its own workStealingDeque of tasks. Listing a directory pushes the subdirectories
+ * and files the walk rules accept onto the lister's own deque, a large file
+ * as several chunk tasks (see appendFileTasks); each file or chunk task is
+ * searched with runFileTask. Idle threads steal the oldest
+ * tasks from their peers. The function returns once every task is done; it
+ * does not close the result channel.
+ */
+void fusedSearch(
+    const std::filesystem::path& rootDir,
+    channel<MatchSlab*>* resultChan,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    const CpuTopology& topology,
+    const PoolSettings& poolSettings,
+    const WalkRules& rules,
+    const FileFilter* filter
+);
+
+#endif // FUSED_SEARCH_H
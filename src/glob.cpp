@@ -0,0 +1,216 @@
+/**
+ * @file src/glob.cpp
+ *
+ * @brief Implementation of GlobPattern and gitignore-style rule parsing.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of GlobPattern. The constructor looks
+ * for the three common forms that need no wildcard matching at all. Every
+ * other pattern goes through globMatch, a backtracking matcher that works
+ * directly on the pattern text; patterns and names are short, so it does not
+ * need to build an automaton.
+ */
+
+#include "glob.h"
+#include <cstring>
+
+/**
+ * @brief Whether a character has a special meaning in a glob
+ */
+static bool isGlobSpecial(char c) {
+    return c == '*' || c == '?' || c == '[' || c == '\\';
+}
+
+/**
+ * @brief Whether a range of text holds no glob special character
+ */
+static bool isPlain(const char* begin, const char* end) {
+    for (const char* p = begin; p < end; ++p) {
+        if (isGlobSpecial(*p)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Match one character against a "[...]" set
+ *
+ * @param p Points just past the "["
+ * @param pe End of the pattern
+ * @param c The character to test
+ * @param next Set to just past the closing "]"
+ *
+ * @return 1 if c is in the set, 0 if not, -1 if the set is never closed
+ */
+static int matchSet(const char* p, const char* pe, char c, const char*& next) {
+    bool negate = false;
+    if (p < pe && (*p == '!' || *p == '^')) {
+        negate = true;
+        ++p;
+    }
+    bool found = false;
+    bool first = true;
+    while (p < pe && (first || *p != ']')) {
+        first = false;
+        char lo = *p++;
+        if (lo == '\\' && p < pe) lo = *p++;
+        char hi = lo;
+        if (p + 1 < pe && *p == '-' && p[1] != ']') {
+            hi = p[1];
+            p += 2;
+            if (hi == '\\' && p < pe) hi = *p++;
+        }
+        if (lo <= c && c <= hi) found = true;
+    }
+    if (p >= pe) return -1;
+    next = p + 1;
+    return found != negate ? 1 : 0;
+}
+
+/**
+ * @brief Match a glob against a whole text, backtracking on wildcards
+ */
+static bool globMatch(const char* p, const char* pe, const char* t, const char* te) {
+    while (p < pe) {
+        char c = *p;
+        if (c == '*') {
+            if (p + 1 < pe && p[1] == '*') {
+                const char* rest = p + 2;
+                if (rest < pe && *rest == '/') {
+                    // "**/" matches nothing or any run of whole directories
+                    ++rest;
+                    if (globMatch(rest, pe, t, te)) return true;
+                    for (const char* s = t; s < te; ++s) {
+                        if (*s == '/' && globMatch(rest, pe, s + 1, te)) return true;
+                    }
+                    return false;
+                }
+                for (const char* s = t;; ++s) {
+                    if (globMatch(rest, pe, s, te)) return true;
+                    if (s == te) return false;
+                }
+            }
+            ++p;
+            for (const char* s = t;; ++s) {
+                if (globMatch(p, pe, s, te)) return true;
+                if (s == te || *s == '/') return false;
+            }
+        }
+        if (t == te) return false;
+        if (c == '?') {
+            if (*t == '/') return false;
+        } else if (c == '[') {
+            const char* next = nullptr;
+            int in = *t == '/' ? 0 : matchSet(p + 1, pe, *t, next);
+            if (in == 0) return false;
+            if (in > 0) {
+                p = next;
+                ++t;
+                continue;
+            }
+            // An unclosed "[" is an ordinary character
+            if (*t != '[') return false;
+        } else {
+            if (c == '\\' && p + 1 < pe) c = *++p;
+            if (*t != c) return false;
+        }
+        ++p;
+        ++t;
+    }
+    return t == te;
+}
+
+/**
+ * @brief Compile a pattern, recognising the forms that need no wildcard matching
+ *
+ * @param pattern The glob text
+ */
+GlobPattern::GlobPattern(const std::string& pattern) : glob(pattern) {
+    const char* begin = glob.data();
+    const char* end = begin + glob.size();
+    if (isPlain(begin, end)) {
+        kind = shape::literal;
+        fixed = glob;
+    } else if (glob.size() > 1 && glob[0] == '*' && isPlain(begin + 1, end)) {
+        kind = shape::suffix;
+        fixed = glob.substr(1);
+    } else if (glob.size() > 1 && glob.back() == '*' && isPlain(begin, end - 1)) {
+        kind = shape::prefix;
+        fixed = glob.substr(0, glob.size() - 1);
+    }
+}
+
+bool GlobPattern::matches(const std::string& text) const {
+    const std::size_t n = fixed.size();
+    switch (kind) {
+        case shape::literal:
+            return text == fixed;
+        case shape::suffix:
+            // The "*" may not cross a directory boundary
+            return text.size() >= n
+                && text.compare(text.size() - n, n, fixed) == 0
+                && std::memchr(text.data(), '/', text.size() - n) == nullptr;
+        case shape::prefix:
+            return text.size() >= n
+                && text.compare(0, n, fixed) == 0
+                && std::memchr(text.data() + n, '/', text.size() - n) == nullptr;
+        case shape::general:
+            break;
+    }
+    return globMatch(glob.data(), glob.data() + glob.size(), text.data(), text.data() + text.size());
+}
+
+/**
+ * @brief Whether the rule matches a path
+ *
+ * @param relative The path relative to the rule's base directory
+ * @param name The last component of the path
+ * @param isDirectory Whether the path is a directory
+ */
+bool PathRule::matches(const std::string& relative, const std::string& name, bool isDirectory) const {
+    if (dir_only && !isDirectory) {
+        return false;
+    }
+    return glob.matches(anchored ? relative : name);
+}
+
+std::optional<PathRule> parsePathRule(const std::string& line) {
+    std::string text = line;
+    if (!text.empty() && text.back() == '\r') text.pop_back();
+    // Trailing spaces are dropped unless escaped
+    while (!text.empty() && text.back() == ' ' && !(text.size() > 1 && text[text.size() - 2] == '\\')) {
+        text.pop_back();
+    }
+    if (text.empty() || text[0] == '#') {
+        return std::nullopt;
+    }
+
+    bool negate = false;
+    if (text[0] == '!') {
+        negate = true;
+        text.erase(0, 1);
+    } else if (text.size() > 1 && text[0] == '\\' && (text[1] == '#' || text[1] == '!')) {
+        text.erase(0, 1);
+    }
+    bool dirOnly = false;
+    if (!text.empty() && text.back() == '/') {
+        dirOnly = true;
+        text.pop_back();
+    }
+    bool anchored = text.find('/') != std::string::npos;
+    if (!text.empty() && text[0] == '/') {
+        text.erase(0, 1);
+    }
+    if (text.empty()) {
+        return std::nullopt;
+    }
+
+    PathRule rule{GlobPattern(text)};
+    rule.negate = negate;
+    rule.dir_only = dirOnly;
+    rule.anchored = anchored;
+    return rule;
+}
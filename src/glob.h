@@ -0,0 +1,89 @@
+/**
+ * @file src/glob.h
+ *
+ * @brief Declaration of the compiled glob patterns used to filter paths.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of GlobPattern, a shell-style wildcard
+ * pattern compiled once and matched against file names and slash-separated
+ * relative paths, and of PathRule, one line of a .gitignore file or one
+ * --include/--exclude argument. Most patterns in practice are a plain name
+ * ("build"), a suffix ("*.o") or a prefix ("tmp*"); those are recognised
+ * when the pattern is compiled and matched with a single comparison instead
+ * of the general wildcard matcher.
+ */
+
+#ifndef GLOB_H
+#define GLOB_H
+
+#include <optional>
+#include <string>
+
+/**
+ * @class GlobPattern
+ *
+ * @brief A wildcard pattern compiled for fast matching
+ *
+ * @details Supported syntax: "*" matches any run of characters except "/",
+ * "**" matches any run including "/", and "**" followed by "/" also matches
+ * nothing, so "**" + "/a" matches "a" at any depth. "?" matches one character
+ * other than "/", "[abc]", "[a-z]" and "[!a-z]" (or "[^a-z]") match one
+ * character from a set, and "\" makes the next character literal.
+ */
+class GlobPattern {
+public:
+    explicit GlobPattern(const std::string& pattern);
+
+    bool matches(const std::string& text) const;
+    const std::string& pattern() const { return glob; }
+
+private:
+    // Fast forms recognised at compile time; general runs the full matcher
+    enum class shape { literal, suffix, prefix, general };
+
+    std::string glob;
+    shape kind = shape::general;
+    std::string fixed; // the literal part of a literal, suffix or prefix pattern
+};
+
+/**
+ * @struct PathRule
+ *
+ * @brief One gitignore-style rule
+ *
+ * @var glob The compiled pattern
+ * @var negate The rule re-includes what an earlier rule excluded ("!pattern")
+ * @var dir_only The rule only applies to directories ("pattern/")
+ * @var anchored The pattern is matched against the path relative to the
+ *      rule's base directory rather than against the last path component; true
+ *      when the pattern contains a "/" anywhere but at its end
+ */
+struct PathRule {
+    GlobPattern glob;
+    bool negate = false;
+    bool dir_only = false;
+    bool anchored = false;
+
+    bool matches(const std::string& relative, const std::string& name, bool isDirectory) const;
+};
+
+/**
+ * @brief Parse one line of a .gitignore file, or one --include/--exclude glob
+ *
+ * @param line The text of the line
+ *
+ * @return std::optional<PathRule> The rule, or nothing for blank lines and
+ * comments
+ *
+ * @details Trailing spaces and a trailing carriage return are dropped. A
+ * leading "!" negates the rule, a trailing "/" restricts it to directories and
+ * a leading "/" anchors it to the base directory. "\#" and "\!" start a
+ * pattern with a literal "#" or "!".
+ */
+std::optional<PathRule> parsePathRule(const std::string& line);
+
+#endif // GLOB_H
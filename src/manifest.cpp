@@ -0,0 +1,278 @@
+/**
+ * @file src/manifest.cpp
+ *
+ * @brief Implementation of the per-query file manifest.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of Manifest. The file format is a
+ * short header (magic, version, query) followed by one record per file:
+ * its root-relative path, size, mtime in nanoseconds, inode and matches
+ * (line number, matching pattern, line text).
+ * Strings are stored as a 32-bit length followed by the bytes; all numbers
+ * are in native byte order. The manifest is read through FileBuffer and
+ * written to a temporary file that is renamed into place.
+ */
+
+#include "manifest.h"
+#include "file_buffer.h"
+#include "match_pool.h"
+#include "trigram_index.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+namespace {
+
+const char MANIFEST_MAGIC[8] = {'S', 'R', 'C', 'H', 'M', 'A', 'N', '\0'};
+const std::uint32_t MANIFEST_VERSION = 2;
+
+/**
+ * @brief Bounds-checked reader over the loaded manifest bytes
+ *
+ * @details Once a read runs past the end, ok() stays false and every later
+ * read returns zeros, so the caller only checks once per record.
+ */
+class ManifestReader {
+public:
+    ManifestReader(const char* data, std::size_t size) : p(data), end(data + size) {}
+
+    template <class T>
+    T number() {
+        T value{};
+        if (static_cast<std::size_t>(end - p) < sizeof(T)) {
+            good = false;
+            p = end;
+            return value;
+        }
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    std::string text() {
+        std::uint32_t n = number<std::uint32_t>();
+        if (static_cast<std::size_t>(end - p) < n) {
+            good = false;
+            p = end;
+            return std::string();
+        }
+        std::string value(p, n);
+        p += n;
+        return value;
+    }
+
+    bool ok() const { return good; }
+
+private:
+    const char* p;
+    const char* end;
+    bool good = true;
+};
+
+template <class T>
+void putNumber(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void putText(std::string& out, const std::string& value) {
+    putNumber(out, static_cast<std::uint32_t>(value.size()));
+    out += value;
+}
+
+} // namespace
+
+bool Manifest::load(
+    const std::filesystem::path& manifestPath,
+    const std::filesystem::path& rootDir,
+    const std::string& query,
+    std::string& error
+) {
+    rootPrefix = indexRootPrefix(rootDir);
+    this->query = query;
+    entries.clear();
+
+    std::error_code ec;
+    if (!std::filesystem::exists(manifestPath, ec)) {
+        return true; // first run
+    }
+    FileBuffer buffer(manifestPath);
+    if (!buffer.isOpen()) {
+        error = "cannot be read";
+        return false;
+    }
+
+    ManifestReader in(buffer.data(), buffer.size());
+    char magic[sizeof(MANIFEST_MAGIC)];
+    for (char& c : magic) c = in.number<char>();
+    if (!in.ok() || std::memcmp(magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) != 0
+        || in.number<std::uint32_t>() != MANIFEST_VERSION) {
+        error = "not a manifest file or from another version";
+        return false;
+    }
+    if (in.text() != query) {
+        return true; // written for another query; this run replaces it
+    }
+
+    std::uint64_t count = in.number<std::uint64_t>();
+    for (std::uint64_t i = 0; i < count && in.ok(); ++i) {
+        std::string key = in.text();
+        Entry entry;
+        entry.size = in.number<std::uint64_t>();
+        entry.mtime = in.number<std::int64_t>();
+        entry.inode = in.number<std::uint64_t>();
+        std::uint32_t matchCount = in.number<std::uint32_t>();
+        for (std::uint32_t m = 0; m < matchCount && in.ok(); ++m) {
+            CachedMatch cached;
+            cached.line_number = in.number<std::int32_t>();
+            cached.pattern = in.number<std::uint32_t>();
+            cached.line_content = in.text();
+            entry.matches.push_back(std::move(cached));
+        }
+        if (in.ok()) {
+            entries.emplace(std::move(key), std::move(entry));
+        }
+    }
+    if (!in.ok()) {
+        entries.clear();
+        error = "truncated or corrupt";
+        return false;
+    }
+    return true;
+}
+
+bool Manifest::checkFile(const std::filesystem::path& filePath) {
+    struct stat st;
+    bool statOk = ::stat(filePath.c_str(), &st) == 0;
+    std::string key = indexKey(rootPrefix, filePath);
+
+    std::lock_guard<std::mutex> lk(mut);
+    Entry& entry = entries[key];
+    if (statOk && entry.state == entryState::stale
+        && entry.size == static_cast<std::uint64_t>(st.st_size)
+        && entry.mtime == std::int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec
+        && entry.inode == static_cast<std::uint64_t>(st.st_ino)) {
+        entry.state = entryState::reused;
+        ++reused;
+        return true;
+    }
+
+    // New or changed (or walked twice): search it and start its record afresh
+    entry.size = statOk ? static_cast<std::uint64_t>(st.st_size) : 0;
+    entry.mtime = statOk ? std::int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec : -1;
+    entry.inode = statOk ? static_cast<std::uint64_t>(st.st_ino) : 0;
+    entry.matches.clear();
+    if (entry.state != entryState::rescanned) {
+        if (entry.state == entryState::reused) --reused;
+        entry.state = entryState::rescanned;
+        ++rescanned;
+    }
+    return false;
+}
+
+void Manifest::record(const MatchSlab& slab) {
+    std::string key = indexKey(rootPrefix, slab.file_path);
+    std::lock_guard<std::mutex> lk(mut);
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.state != entryState::rescanned) {
+        return;
+    }
+    if (slab.matches.empty()) {
+        it->second.matches.push_back(CachedMatch{static_cast<int>(std::min<std::size_t>(slab.count, INT_MAX)), "", 0});
+        return;
+    }
+    for (const Match& m : slab.matches) {
+        it->second.matches.push_back(CachedMatch{m.line_number, std::string(slab.line(m)), m.pattern});
+    }
+}
+
+void Manifest::replay(channel<MatchSlab*>* resultChan, reportMode mode) {
+    // Built under the lock but sent after it is released: the printer takes
+    // the same lock in record(), so sending while holding it could deadlock
+    std::vector<MatchSlab*> perFile;
+    {
+        std::lock_guard<std::mutex> lk(mut);
+        for (const auto& item : entries) {
+            if (item.second.state != entryState::reused || item.second.matches.empty()) {
+                continue;
+            }
+            MatchSlab* slab = matchSlabPool().acquire();
+            slab->thread_id = std::this_thread::get_id();
+            slab->file_path = rootPrefix + item.first;
+            if (mode != reportMode::lines) {
+                slab->count = static_cast<std::size_t>(item.second.matches.front().line_number);
+            } else {
+                for (const CachedMatch& cached : item.second.matches) {
+                    const char* text = cached.line_content.data();
+                    slab->add(cached.line_number, cached.pattern, text, text + cached.line_content.size());
+                }
+            }
+            perFile.push_back(slab);
+        }
+    }
+    for (MatchSlab* slab : perFile) {
+        resultChan->send(slab);
+    }
+}
+
+bool Manifest::save(const std::filesystem::path& manifestPath) {
+    std::string out;
+    out.append(MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+    putNumber(out, MANIFEST_VERSION);
+    putText(out, query);
+
+    std::lock_guard<std::mutex> lk(mut);
+    std::uint64_t kept = 0;
+    for (const auto& item : entries) {
+        if (item.second.state != entryState::stale) ++kept;
+    }
+    putNumber(out, kept);
+    for (const auto& item : entries) {
+        const Entry& entry = item.second;
+        if (entry.state == entryState::stale) {
+            continue; // deleted, or no longer walked
+        }
+        putText(out, item.first);
+        putNumber(out, entry.size);
+        putNumber(out, entry.mtime);
+        putNumber(out, entry.inode);
+        putNumber(out, static_cast<std::uint32_t>(entry.matches.size()));
+        for (const CachedMatch& cached : entry.matches) {
+            putNumber(out, static_cast<std::int32_t>(cached.line_number));
+            putNumber(out, static_cast<std::uint32_t>(cached.pattern));
+            putText(out, cached.line_content);
+        }
+    }
+
+    std::filesystem::path tmpPath = manifestPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, manifestPath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::size_t Manifest::removedFiles() const {
+    std::size_t removed = 0;
+    for (const auto& item : entries) {
+        if (item.second.state == entryState::stale) ++removed;
+    }
+    return removed;
+}
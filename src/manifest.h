@@ -0,0 +1,129 @@
+/**
+ * @file src/manifest.h
+ *
+ * @brief Declaration of the on-disk manifest that lets a repeated query
+ *        skip files that have not changed.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of the Manifest class. For one query
+ * the manifest remembers, per file, the size, modification time and inode the
+ * file had when it was last searched, together with the matching lines found
+ * in it. On the next run with the same query, files whose metadata is
+ * unchanged are not read again; their remembered matches are replayed
+ * instead. Changed and new files are searched as usual and deleted files drop
+ * out of the manifest when it is saved.
+ *
+ * The manifest belongs to one query: loading a manifest written for another
+ * query (or a different search mode) starts from empty and the new run
+ * replaces it.
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "channel.h"
+#include "match.h"
+
+/**
+ * @class Manifest
+ *
+ * @brief Per-file metadata and cached matches for one query
+ *
+ * @details During a run, walker threads call checkFile() for every file they
+ * find, the printer calls record() for every match it prints, and the main
+ * thread calls replay() and save() after the search. All of these may run at
+ * the same time, so the entries are guarded by one mutex.
+ */
+class Manifest {
+public:
+    /**
+     * @brief Load a manifest written by an earlier run
+     *
+     * @param manifestPath The manifest file; a missing file is not an error
+     * @param rootDir The directory being searched
+     * @param query Identifies the query and every option that affects matches
+     * @param error Set to the reason when false is returned
+     *
+     * @return false if the file exists but could not be used; the manifest is
+     * then empty and will be overwritten by save()
+     */
+    bool load(
+        const std::filesystem::path& manifestPath,
+        const std::filesystem::path& rootDir,
+        const std::string& query,
+        std::string& error
+    );
+
+    /**
+     * @brief Decide whether a walked file can reuse its cached matches
+     *
+     * @return true if the file is unchanged and its matches will be replayed;
+     * false if it has to be searched, in which case its new metadata is
+     * recorded and record() collects its matches
+     */
+    bool checkFile(const std::filesystem::path& filePath);
+
+    /**
+     * @brief Remember the matches found in a file that was searched this run
+     *
+     * @details A summary slab is remembered as one match whose line number
+     * is the count.
+     */
+    void record(const MatchSlab& slab);
+
+    /**
+     * @brief Send the cached matches of every reused file, one slab per file
+     *
+     * @param resultChan The channel the printer reads
+     * @param mode What the query reports; for files and counts the slabs are summaries
+     */
+    void replay(channel<MatchSlab*>* resultChan, reportMode mode);
+
+    /**
+     * @brief Write the files seen this run and their matches
+     *
+     * @return false if the manifest could not be written
+     */
+    bool save(const std::filesystem::path& manifestPath);
+
+    std::size_t reusedFiles() const { return reused; }
+    std::size_t rescannedFiles() const { return rescanned; }
+    std::size_t removedFiles() const;
+
+private:
+    struct CachedMatch {
+        int line_number;
+        std::string line_content;
+        std::size_t pattern;
+    };
+
+    enum class entryState { stale, reused, rescanned };
+
+    struct Entry {
+        std::uint64_t size = 0;
+        std::int64_t mtime = 0;
+        std::uint64_t inode = 0;
+        entryState state = entryState::stale;
+        std::vector<CachedMatch> matches;
+    };
+
+    std::mutex mut;
+    std::string rootPrefix;
+    std::string query;
+    std::unordered_map<std::string, Entry> entries;
+    std::size_t reused = 0;
+    std::size_t rescanned = 0;
+};
+
+#endif // MANIFEST_H
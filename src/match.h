@@ -0,0 +1,125 @@
+/**
+ * @file src/match.h
+ * 
+ * @brief Declaration of the Match records the workers send to the printer.
+ * 
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date November 20, 2025
+ * 
+ * @section Overview
+ * 
+ * This file contains the declaration of the Match structure, one matching
+ * line, and of MatchSlab, which carries all of one file's matches from a
+ * worker to the printer, and of reportMode, which says whether workers send
+ * lines or per-file summaries. A slab stores the file's path once and the
+ * text of every matching line back to back in one buffer, so a file with
+ * thousands of hits costs two growing buffers rather than a path and a
+ * string per hit. Slabs come from a MatchSlabPool (see match_pool.h) and go
+ * back to it once printed, keeping their capacity for the next file.
+ */
+
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+// Sequence number of a file that was not numbered (output is not being sorted)
+constexpr std::uint64_t NO_SEQUENCE = std::numeric_limits<std::uint64_t>::max();
+
+/**
+ * @struct Match
+ * 
+ * @brief One matching line, stored in the MatchSlab of its file
+ * 
+ * @var line_number The line number of the match in the file
+ * @var pattern Index of the pattern that matched (always 0 with one pattern)
+ * @var text_offset Where the line's text starts in the slab's text
+ * @var text_length Length of the line's text
+ */
+struct Match {
+    int line_number = 0;
+    std::uint32_t pattern = 0;
+    std::size_t text_offset = 0;
+    std::size_t text_length = 0;
+};
+
+/**
+ * @struct MatchSlab
+ * 
+ * @brief Everything the printer gets about one file
+ * 
+ * @var thread_id The ID of the thread that searched the file
+ * @var file_path The path of the file, shared by all of its matches
+ * @var matches The matching lines in file order
+ * @var text The text of every matching line, back to back
+ * @var count The number of matching lines, when reporting files or counts
+ * @var sequence The file's place in traversal order with --sort, NO_SEQUENCE otherwise
+ * 
+ * @details When reporting files or counts a worker sends a slab with no
+ * matches and only count set. With --sort a file without matches still sends
+ * a slab, with neither matches nor a count, so the printer knows it is done.
+ */
+struct MatchSlab {
+    std::thread::id thread_id;
+    std::filesystem::path file_path;
+    std::vector<Match> matches;
+    std::string text;
+    std::size_t count = 0;
+    std::uint64_t sequence = NO_SEQUENCE;
+
+    /**
+     * @brief Whether the slab has nothing to print (a finished file in --sort mode)
+     */
+    bool empty() const {
+        return matches.empty() && count == 0;
+    }
+
+    /**
+     * @brief Append a matching line, copying its text into the slab
+     */
+    void add(int lineNumber, std::size_t pattern, const char* begin, const char* end) {
+        Match m;
+        m.line_number = lineNumber;
+        m.pattern = static_cast<std::uint32_t>(pattern);
+        m.text_offset = text.size();
+        m.text_length = static_cast<std::size_t>(end - begin);
+        text.append(begin, end);
+        matches.push_back(m);
+    }
+
+    /**
+     * @brief The text of one of this slab's matches
+     */
+    std::string_view line(const Match& m) const {
+        return std::string_view(text.data() + m.text_offset, m.text_length);
+    }
+
+    /**
+     * @brief Empty the slab for another file, keeping its buffers
+     */
+    void clear() {
+        matches.clear();
+        text.clear();
+        count = 0;
+        sequence = NO_SEQUENCE;
+    }
+};
+
+/**
+ * @enum reportMode
+ * 
+ * @brief What the workers report for a file that matches
+ * 
+ * @details lines sends every matching line; files (-l) and counts (-c) send
+ * a summary slab per file.
+ */
+enum class reportMode { lines, files, counts };
+
+#endif // MATCH_H
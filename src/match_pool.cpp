@@ -0,0 +1,55 @@
+/**
+ * @file src/match_pool.cpp
+ *
+ * @brief Implementation of the MatchSlab pool.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ */
+
+#include "match_pool.h"
+#include <utility>
+
+MatchSlab* MatchSlabPool::acquire() {
+    std::lock_guard<std::mutex> lk(mut);
+    if (!free.empty()) {
+        MatchSlab* slab = free.back();
+        free.pop_back();
+        return slab;
+    }
+    owned.push_back(std::make_unique<MatchSlab>());
+    return owned.back().get();
+}
+
+void MatchSlabPool::release(MatchSlab* slab) {
+    trim(*slab);
+    std::lock_guard<std::mutex> lk(mut);
+    free.push_back(slab);
+}
+
+void MatchSlabPool::release(std::vector<MatchSlab*>& slabs) {
+    for (MatchSlab* slab : slabs) {
+        trim(*slab);
+    }
+    std::lock_guard<std::mutex> lk(mut);
+    free.insert(free.end(), slabs.begin(), slabs.end());
+    slabs.clear();
+}
+
+/**
+ * @brief Empty a slab, dropping its buffers if they grew past SLAB_KEEP_BYTES
+ */
+void MatchSlabPool::trim(MatchSlab& slab) {
+    if (slab.text.capacity() > SLAB_KEEP_BYTES) {
+        std::string().swap(slab.text);
+    }
+    if (slab.matches.capacity() * sizeof(Match) > SLAB_KEEP_BYTES) {
+        std::vector<Match>().swap(slab.matches);
+    }
+    slab.clear();
+}
+
+MatchSlabPool& matchSlabPool() {
+    static MatchSlabPool pool;
+    return pool;
+}
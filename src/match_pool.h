@@ -0,0 +1,62 @@
+/**
+ * @file src/match_pool.h
+ *
+ * @brief Declaration of the pool that recycles MatchSlabs between the workers and the printer.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of MatchSlabPool. Workers take a slab,
+ * fill it with a file's matches and send it on the result channel; the
+ * printer gives every slab back once it has printed it. A recycled slab keeps
+ * its match vector, text buffer and path storage, so once the pool has
+ * warmed up a search allocates nothing per match and next to nothing per
+ * file. The pool owns every slab it ever made; since the result channel is
+ * bounded, that is never more than the slabs in flight at once.
+ */
+
+#ifndef MATCH_POOL_H
+#define MATCH_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "match.h"
+
+// A slab whose buffers grew past this many bytes gives them back when released
+constexpr std::size_t SLAB_KEEP_BYTES = std::size_t(1) << 20;
+
+/**
+ * @class MatchSlabPool
+ *
+ * @brief Free list of empty MatchSlabs, shared by all threads
+ *
+ * @details acquire() returns an empty slab, reusing a released one when
+ * there is one. release() empties slabs and returns them; the printer
+ * releases a whole received batch under one lock. Slabs that held an
+ * unusually large file drop their buffers first so one huge file does not
+ * pin its memory for the rest of the run.
+ */
+class MatchSlabPool {
+public:
+    MatchSlab* acquire();
+    void release(MatchSlab* slab);
+    void release(std::vector<MatchSlab*>& slabs);
+
+private:
+    static void trim(MatchSlab& slab);
+
+    std::mutex mut;
+    std::vector<std::unique_ptr<MatchSlab>> owned;
+    std::vector<MatchSlab*> free;
+};
+
+/**
+ * @brief The pool every worker and the printer share
+ */
+MatchSlabPool& matchSlabPool();
+
+#endif // MATCH_POOL_H
@@ -0,0 +1,331 @@
+/**
+ * @file src/matcher.cpp
+ *
+ * @brief Implementation of the literal matcher and its SIMD search kernels.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the scalar, SSE2 and AVX2 substring search kernels and
+ * the runtime dispatch that picks between them. The SIMD kernels use the
+ * first/last byte filter: for a needle of length n, the block starting at i
+ * is compared against the first needle byte and the block starting at
+ * i + n - 1 against the last needle byte. Only lanes where both compare
+ * equal are verified with memcmp. Whatever is left at the end of the range
+ * after the last full block is handed to the scalar kernel.
+ *
+ * Each kernel is a template on FoldCase. The case-insensitive instantiations
+ * keep the needle in lower case, compare blocks against both cases of its
+ * first and last byte and verify with a folding compare; the case-sensitive
+ * ones are the original code. makeMatcher() at the end of the file picks
+ * the instantiation for a search.
+ */
+
+#include "matcher.h"
+#include "aho_corasick.h"
+#include "regex_matcher.h"
+#include <cstring>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATCHER_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Lower-case an ASCII letter; other bytes are unchanged
+ */
+static inline unsigned char foldByte(unsigned char c) {
+    return static_cast<unsigned char>(c - 'A') < 26 ? static_cast<unsigned char>(c | 0x20) : c;
+}
+
+/**
+ * @brief The other case of an ASCII letter; other bytes are unchanged
+ */
+static inline unsigned char otherCase(unsigned char c) {
+    return static_cast<unsigned char>((c | 0x20) - 'a') < 26 ? static_cast<unsigned char>(c ^ 0x20) : c;
+}
+
+/**
+ * @brief memcmp() == 0, folding case when FoldCase (the needle is lower case)
+ */
+template <bool FoldCase>
+static inline bool sameBytes(const char* text, const char* needle, std::size_t n) {
+    if constexpr (!FoldCase) {
+        return std::memcmp(text, needle, n) == 0;
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (foldByte(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(needle[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Scalar kernel: memchr for the first byte, memcmp for the rest
+ *
+ * @details Folding scans byte by byte, since memchr looks for one value.
+ */
+template <bool FoldCase>
+static const char* findScalar(
+    const char* begin,
+    const char* end,
+    const char* needle,
+    std::size_t n
+) {
+    if (n == 0) return begin;
+    if (static_cast<std::size_t>(end - begin) < n) return nullptr;
+
+    const char* lastStart = end - n;
+    const char* p = begin;
+    if constexpr (FoldCase) {
+        const unsigned char first = static_cast<unsigned char>(needle[0]);
+        for (; p <= lastStart; ++p) {
+            if (foldByte(static_cast<unsigned char>(*p)) == first
+                && sameBytes<true>(p + 1, needle + 1, n - 1)) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+    while (p <= lastStart) {
+        p = static_cast<const char*>(std::memchr(p, needle[0], lastStart - p + 1));
+        if (!p) return nullptr;
+        if (std::memcmp(p + 1, needle + 1, n - 1) == 0) return p;
+        ++p;
+    }
+    return nullptr;
+}
+
+#ifdef MATCHER_X86
+
+/**
+ * @brief SSE2 kernel: 16 candidate positions per iteration
+ */
+template <bool FoldCase>
+static const char* findSSE2(
+    const char* begin,
+    const char* end,
+    const char* needle,
+    std::size_t n
+) {
+    if (n < 2) return findScalar<FoldCase>(begin, end, needle, n);
+    std::size_t len = static_cast<std::size_t>(end - begin);
+    if (len < n) return nullptr;
+
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[n - 1]);
+    const __m128i firstOther = _mm_set1_epi8(static_cast<char>(otherCase(static_cast<unsigned char>(needle[0]))));
+    const __m128i lastOther = _mm_set1_epi8(static_cast<char>(otherCase(static_cast<unsigned char>(needle[n - 1]))));
+
+    std::size_t i = 0;
+    for (; i + n - 1 + 16 <= len; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin + i + n - 1));
+        __m128i eqFirst = _mm_cmpeq_epi8(blockFirst, first);
+        __m128i eqLast = _mm_cmpeq_epi8(blockLast, last);
+        if constexpr (FoldCase) {
+            eqFirst = _mm_or_si128(eqFirst, _mm_cmpeq_epi8(blockFirst, firstOther));
+            eqLast = _mm_or_si128(eqLast, _mm_cmpeq_epi8(blockLast, lastOther));
+        }
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast)));
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            const char* candidate = begin + i + bit;
+            if (sameBytes<FoldCase>(candidate + 1, needle + 1, n - 2)) return candidate;
+            mask &= mask - 1;
+        }
+    }
+    return findScalar<FoldCase>(begin + i, end, needle, n);
+}
+
+/**
+ * @brief AVX2 kernel: 32 candidate positions per iteration
+ *
+ * @details Compiled for AVX2 with a target attribute so the rest of the
+ * program does not require it; only called after the CPU check passes.
+ */
+template <bool FoldCase>
+__attribute__((target("avx2")))
+static const char* findAVX2(
+    const char* begin,
+    const char* end,
+    const char* needle,
+    std::size_t n
+) {
+    if (n < 2) return findScalar<FoldCase>(begin, end, needle, n);
+    std::size_t len = static_cast<std::size_t>(end - begin);
+    if (len < n) return nullptr;
+
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[n - 1]);
+    const __m256i firstOther = _mm256_set1_epi8(static_cast<char>(otherCase(static_cast<unsigned char>(needle[0]))));
+    const __m256i lastOther = _mm256_set1_epi8(static_cast<char>(otherCase(static_cast<unsigned char>(needle[n - 1]))));
+
+    std::size_t i = 0;
+    for (; i + n - 1 + 32 <= len; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin + i + n - 1));
+        __m256i eqFirst = _mm256_cmpeq_epi8(blockFirst, first);
+        __m256i eqLast = _mm256_cmpeq_epi8(blockLast, last);
+        if constexpr (FoldCase) {
+            eqFirst = _mm256_or_si256(eqFirst, _mm256_cmpeq_epi8(blockFirst, firstOther));
+            eqLast = _mm256_or_si256(eqLast, _mm256_cmpeq_epi8(blockLast, lastOther));
+        }
+        std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eqFirst, eqLast)));
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            const char* candidate = begin + i + bit;
+            if (sameBytes<FoldCase>(candidate + 1, needle + 1, n - 2)) return candidate;
+            mask &= mask - 1;
+        }
+    }
+    return findScalar<FoldCase>(begin + i, end, needle, n);
+}
+
+#endif // MATCHER_X86
+
+bool searchKernelSupported(SearchKernel kernel) {
+    switch (kernel) {
+        case SearchKernel::Scalar:
+            return true;
+#ifdef MATCHER_X86
+        case SearchKernel::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case SearchKernel::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+SearchKernel bestSearchKernel() {
+    static const SearchKernel best = [] {
+        if (searchKernelSupported(SearchKernel::AVX2)) return SearchKernel::AVX2;
+        if (searchKernelSupported(SearchKernel::SSE2)) return SearchKernel::SSE2;
+        return SearchKernel::Scalar;
+    }();
+    return best;
+}
+
+const char* searchKernelName(SearchKernel kernel) {
+    switch (kernel) {
+        case SearchKernel::SSE2: return "sse2";
+        case SearchKernel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * @brief Build a matcher for a literal needle
+ *
+ * @param needle The string to search for
+ * @param kernel The kernel to run; falls back to scalar if unsupported
+ */
+template <bool FoldCase, bool WholeWord>
+BasicLiteralMatcher<FoldCase, WholeWord>::BasicLiteralMatcher(const std::string& needle, SearchKernel kernel)
+    : needle(needle), chosen(kernel), findFn(findScalar<FoldCase>) {
+    if (FoldCase) {
+        for (char& c : this->needle) {
+            c = static_cast<char>(foldByte(static_cast<unsigned char>(c)));
+        }
+    }
+    if (!searchKernelSupported(chosen)) {
+        chosen = SearchKernel::Scalar;
+    }
+#ifdef MATCHER_X86
+    if (chosen == SearchKernel::SSE2) findFn = findSSE2<FoldCase>;
+    if (chosen == SearchKernel::AVX2) findFn = findAVX2<FoldCase>;
+#endif
+}
+
+/**
+ * @brief Letters, digits and the underscore make up words
+ */
+static inline bool isWordByte(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return static_cast<unsigned char>((u | 0x20) - 'a') < 26 || static_cast<unsigned char>(u - '0') < 10 || u == '_';
+}
+
+template <bool FoldCase, bool WholeWord>
+const char* BasicLiteralMatcher<FoldCase, WholeWord>::find(const char* begin, const char* end) const {
+    if constexpr (!WholeWord) {
+        return findFn(begin, end, needle.data(), needle.size());
+    } else {
+        const std::size_t n = needle.size();
+        const char* p = begin;
+        while (p <= end) {
+            const char* hit = findFn(p, end, needle.data(), n);
+            if (!hit) return nullptr;
+            bool wordBefore = hit > begin && isWordByte(hit[-1]);
+            bool wordAfter = hit + n < end && isWordByte(hit[n]);
+            if (!wordBefore && !wordAfter) return hit;
+            p = hit + 1;
+        }
+        return nullptr;
+    }
+}
+
+template class BasicLiteralMatcher<false, false>;
+template class BasicLiteralMatcher<true, false>;
+template class BasicLiteralMatcher<false, true>;
+template class BasicLiteralMatcher<true, true>;
+
+/**
+ * @brief Build M, or M wrapped in an InvertedMatcher
+ */
+template <class M, class... Args>
+static Matcher* buildMatcher(bool invert, Args&&... args) {
+    if (invert) {
+        return new InvertedMatcher<M>(std::forward<Args>(args)...);
+    }
+    return new M(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Escape the regex metacharacters of a literal pattern
+ */
+static std::string escapeRegex(const std::string& literal) {
+    std::string escaped;
+    for (char c : literal) {
+        if (std::strchr(".[]()|*+?{}^$\\", c) && c != '\0') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+Matcher* makeMatcher(const std::vector<std::string>& patterns, patternSyntax syntax, const MatchOptions& options) {
+    const bool fold = options.ignore_case;
+    const bool invert = options.invert;
+
+    // Word boundaries around several literals need the regex engine, since
+    // a rejected occurrence of one pattern may hide another at the same place
+    if (syntax == patternSyntax::regex || (options.whole_word && patterns.size() > 1)) {
+        std::vector<std::string> regexes;
+        for (const std::string& pattern : patterns) {
+            std::string regex = syntax == patternSyntax::regex ? pattern : escapeRegex(pattern);
+            if (options.whole_word) {
+                regex = "(^|[^[:alnum:]_])(" + regex + ")([^[:alnum:]_]|$)";
+            }
+            regexes.push_back(std::move(regex));
+        }
+        return buildMatcher<RegexMatcher>(invert, regexes, fold);
+    }
+    if (patterns.size() > 1) {
+        return buildMatcher<AhoCorasickMatcher>(invert, patterns, fold);
+    }
+
+    const std::string& needle = patterns[0];
+    if (options.whole_word) {
+        return fold ? buildMatcher<BasicLiteralMatcher<true, true>>(invert, needle)
+                    : buildMatcher<BasicLiteralMatcher<false, true>>(invert, needle);
+    }
+    return fold ? buildMatcher<BasicLiteralMatcher<true, false>>(invert, needle)
+                : buildMatcher<BasicLiteralMatcher<false, false>>(invert, needle);
+}
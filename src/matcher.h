@@ -0,0 +1,225 @@
+/**
+ * @file src/matcher.h
+ *
+ * @brief Declaration of the matcher interface and the SIMD literal matcher.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of the Matcher interface used by the
+ * search workers to locate a pattern inside a whole file buffer, and the
+ * LiteralMatcher implementation. LiteralMatcher runs one of several search
+ * kernels (scalar, SSE2, AVX2) that is picked once at startup from the CPU
+ * features of the host.
+ *
+ * Case-insensitive, whole-word and inverted matching are template parameters
+ * rather than flags: each combination is its own class whose inner loop has
+ * the mode compiled in, and makeMatcher() picks the one to use once per
+ * search. The default literal search is exactly the plain LiteralMatcher.
+ */
+
+#ifndef MATCHER_H
+#define MATCHER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class Matcher
+ *
+ * @brief Interface for anything that can find a pattern in a byte range
+ *
+ * @details find() returns a pointer to the first byte of the first
+ * occurrence inside [begin, end), or nullptr if there is none. findPattern()
+ * does the same and also reports which pattern was found, for matchers that
+ * search for several at once; single-pattern matchers always report 0.
+ * Implementations must be safe to call from many threads at once.
+ */
+class Matcher {
+public:
+    // Reported by findPattern() for lines that match no pattern (inverted search)
+    static constexpr std::size_t NO_PATTERN = static_cast<std::size_t>(-1);
+
+
+    virtual ~Matcher() {}
+    virtual const char* find(const char* begin, const char* end) const = 0;
+    virtual const char* findPattern(const char* begin, const char* end, std::size_t& pattern) const {
+        pattern = 0;
+        return find(begin, end);
+    }
+};
+
+/**
+ * @enum SearchKernel
+ *
+ * @brief The substring search kernels LiteralMatcher can run
+ *
+ * @details Scalar uses memchr on the first byte followed by memcmp. SSE2 and
+ * AVX2 compare the first and last byte of the needle against 16 or 32
+ * candidate positions at a time and only verify the positions where both
+ * agree.
+ */
+enum class SearchKernel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Best kernel supported by the CPU we are running on
+ *
+ * @return SearchKernel The fastest available kernel
+ *
+ * @details The CPU is probed once and the answer is cached.
+ */
+SearchKernel bestSearchKernel();
+
+/**
+ * @brief Check whether a kernel can run on this CPU
+ *
+ * @param kernel The kernel to check
+ *
+ * @return true if supported, false otherwise
+ */
+bool searchKernelSupported(SearchKernel kernel);
+
+/**
+ * @brief Short printable name for a kernel ("scalar", "sse2", "avx2")
+ *
+ * @param kernel The kernel to name
+ *
+ * @return const char* The kernel name
+ */
+const char* searchKernelName(SearchKernel kernel);
+
+/**
+ * @class BasicLiteralMatcher
+ *
+ * @brief Matcher for a single literal string
+ *
+ * @tparam FoldCase Compare ASCII letters without regard to case
+ * @tparam WholeWord Only accept occurrences with no word byte (letter, digit
+ * or underscore) directly before or after them
+ *
+ * @details The kernel is chosen at construction time; by default the best
+ * one for the host CPU. Passing an explicit kernel is mostly useful for
+ * benchmarks. An empty needle matches at the start of any range. With
+ * FoldCase the kernels compare each candidate byte against both cases of the
+ * first and last needle byte; with WholeWord an occurrence that touches a
+ * word byte is skipped and the search resumes one byte later. Ranges are
+ * expected to start at a line start, so the byte before the range is never
+ * looked at.
+ */
+template <bool FoldCase, bool WholeWord>
+class BasicLiteralMatcher final : public Matcher {
+public:
+    explicit BasicLiteralMatcher(const std::string& needle,
+                                 SearchKernel kernel = bestSearchKernel());
+    const char* find(const char* begin, const char* end) const override;
+    SearchKernel kernel() const { return chosen; }
+
+private:
+    using FindFn = const char* (*)(const char* begin, const char* end,
+                                   const char* needle, std::size_t n);
+
+    std::string needle;
+    SearchKernel chosen;
+    FindFn findFn;
+};
+
+// The default, case-sensitive substring matcher
+using LiteralMatcher = BasicLiteralMatcher<false, false>;
+
+extern template class BasicLiteralMatcher<false, false>;
+extern template class BasicLiteralMatcher<true, false>;
+extern template class BasicLiteralMatcher<false, true>;
+extern template class BasicLiteralMatcher<true, true>;
+
+/**
+ * @class InvertedMatcher
+ *
+ * @brief Finds the lines in which Inner finds nothing
+ *
+ * @details find() returns the start of the first line without an occurrence
+ * and findPattern() reports NO_PATTERN for it. Each line is searched on its
+ * own, newline included, so an empty line is still seen as a line. Inner is
+ * called directly rather than through the Matcher interface.
+ */
+template <class Inner>
+class InvertedMatcher final : public Matcher {
+public:
+    template <class... Args>
+    explicit InvertedMatcher(Args&&... args) : inner(std::forward<Args>(args)...) {}
+
+    const char* find(const char* begin, const char* end) const override {
+        const char* cursor = begin;
+        while (cursor < end) {
+            const char* nl = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+            const char* next = nl ? nl + 1 : end;
+            if (!inner.Inner::find(cursor, next)) {
+                return cursor;
+            }
+            cursor = next;
+        }
+        return nullptr;
+    }
+
+    const char* findPattern(const char* begin, const char* end, std::size_t& pattern) const override {
+        pattern = NO_PATTERN;
+        return find(begin, end);
+    }
+
+private:
+    Inner inner;
+};
+
+/**
+ * @struct MatchOptions
+ *
+ * @brief How a pattern has to occur for a line to match
+ *
+ * @var ignore_case ASCII letters match either case
+ * @var whole_word The occurrence must not touch a letter, digit or underscore
+ * @var invert Select the lines that do not match instead
+ */
+struct MatchOptions {
+    bool ignore_case = false;
+    bool whole_word = false;
+    bool invert = false;
+};
+
+/**
+ * @enum patternSyntax
+ *
+ * @brief How the search patterns are interpreted
+ */
+enum class patternSyntax {
+    literal,
+    regex
+};
+
+/**
+ * @brief Build the matcher for a list of patterns
+ *
+ * @param patterns The patterns; must not be empty
+ * @param syntax Whether the patterns are literal text or regular expressions
+ * @param options Case folding, whole-word and inverted matching
+ *
+ * @return Matcher* A new matcher the caller deletes: a BasicLiteralMatcher
+ * for a single literal pattern, an AhoCorasickMatcher for several, and a
+ * RegexMatcher for regular expressions, wrapped in an InvertedMatcher when
+ * inverting. Several literal patterns that must match whole words are
+ * turned into regular expressions.
+ *
+ * @details Throws std::invalid_argument if a regular expression is malformed.
+ */
+Matcher* makeMatcher(const std::vector<std::string>& patterns,
+                     patternSyntax syntax = patternSyntax::literal,
+                     const MatchOptions& options = MatchOptions());
+
+#endif // MATCHER_H
@@ -0,0 +1,331 @@
+/**
+ * @file src/options.cpp
+ *
+ * @brief Implementation of command-line parsing for the search program.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of parseOptions and printUsage.
+ * Any argument starting with "--" is treated as a flag, as are the short
+ * forms in shortFlagName(); everything else is positional (target first unless
+ * patterns were given with -e/-f, then directory). Flag values may be given
+ * as "--flag value" or "--flag=value".
+ */
+
+#include "options.h"
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Parse a positive count such as a thread count
+ *
+ * @param text The text to parse
+ * @param out Set to the parsed number
+ *
+ * @return true if text is a whole number greater than zero
+ */
+static bool parseCount(const std::string& text, unsigned int& out) {
+    try {
+        std::size_t used = 0;
+        unsigned long n = std::stoul(text, &used);
+        if (used != text.size() || n == 0) return false;
+        out = static_cast<unsigned int>(n);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Parse a byte size such as "500K", "20M" or "1G"
+ *
+ * @param text The text to parse: a whole number with an optional K, M or G suffix
+ * @param out Set to the size in bytes
+ *
+ * @return true if text is a valid size greater than zero
+ */
+static bool parseSize(const std::string& text, std::uintmax_t& out) {
+    try {
+        std::size_t used = 0;
+        unsigned long long n = std::stoull(text, &used);
+        unsigned shift = 0;
+        if (used + 1 == text.size()) {
+            char suffix = static_cast<char>(std::toupper(static_cast<unsigned char>(text[used])));
+            if (suffix == 'K') shift = 10;
+            else if (suffix == 'M') shift = 20;
+            else if (suffix == 'G') shift = 30;
+            else return false;
+        } else if (used != text.size()) {
+            return false;
+        }
+        if (n == 0 || n > (UINTMAX_MAX >> shift)) return false;
+        out = static_cast<std::uintmax_t>(n) << shift;
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Append the patterns in a file, one per line
+ *
+ * @param file The pattern file
+ * @param patterns The patterns are appended here
+ *
+ * @return true if the file could be read
+ *
+ * @details Blank lines are skipped and a trailing carriage return is removed,
+ * so files written on Windows work too.
+ */
+static bool readPatternFile(const std::string& file, std::vector<std::string>& patterns) {
+    std::ifstream in(file);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) patterns.push_back(line);
+    }
+    return !in.bad();
+}
+
+/**
+ * @brief The long name of a single-letter flag
+ *
+ * @param arg A command-line argument
+ *
+ * @return The long flag name, or nullptr if arg is not a short flag
+ */
+static const char* shortFlagName(const std::string& arg) {
+    if (arg == "-e") return "--pattern";
+    if (arg == "-f") return "--pattern-file";
+    if (arg == "-E") return "--regex";
+    if (arg == "-i") return "--ignore-case";
+    if (arg == "-w") return "--word-regexp";
+    if (arg == "-v") return "--invert-match";
+    if (arg == "-l") return "--files-with-matches";
+    if (arg == "-c") return "--count";
+    if (arg == "-m") return "--max-count";
+    if (arg == "-a") return "--text";
+    if (arg == "-j") return "--threads";
+    return nullptr;
+}
+
+void printUsage() {
+    std::cerr << "Usage: bin/search [options] <target> [directory]" << std::endl;
+    std::cerr << "       bin/search [options] -e PATTERN... [directory]" << std::endl;
+    std::cerr << "       bin/search index [--index FILE] [directory]" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  -e, --pattern P    Search for P; repeat to search for several patterns at once" << std::endl;
+    std::cerr << "  -f, --pattern-file FILE  Search for every non-blank line of FILE" << std::endl;
+    std::cerr << "  -E, --regex        Treat the patterns as (extended) regular expressions" << std::endl;
+    std::cerr << "  -i, --ignore-case  Match ASCII letters regardless of case" << std::endl;
+    std::cerr << "  -w, --word-regexp  Only match whole words" << std::endl;
+    std::cerr << "  -v, --invert-match Print the lines that do not match" << std::endl;
+    std::cerr << "  -l, --files-with-matches  Print only the names of files that match" << std::endl;
+    std::cerr << "  -c, --count        Print each matching file with its number of matching lines" << std::endl;
+    std::cerr << "  -m, --max-count N  Stop searching a file after N matching lines" << std::endl;
+    std::cerr << "  -a, --text         Search files that look binary instead of skipping them" << std::endl;
+    std::cerr << "  --max-filesize SIZE  Skip files larger than SIZE bytes (K, M or G suffix allowed)" << std::endl;
+    std::cerr << "  --include GLOB     Only search files matching GLOB (repeatable; replaces the default extensions)" << std::endl;
+    std::cerr << "  --exclude GLOB     Skip files and directories matching GLOB (repeatable)" << std::endl;
+    std::cerr << "  --no-ignore        Do not honour .gitignore files or skip .git directories" << std::endl;
+    std::cerr << "  --stats            Print counters, channel wait times and per-thread busy time at the end" << std::endl;
+    std::cerr << "  --lock-free        Use lock-free ring buffers for the channels" << std::endl;
+    std::cerr << "  -j, --threads N    Search with N threads (default one per hardware thread, at least 2)" << std::endl;
+    std::cerr << "  --pin              Pin each search thread to its own CPU" << std::endl;
+    std::cerr << "  --numa             One group of search threads per NUMA node, each with its own file channel" << std::endl;
+    std::cerr << "  --adaptive         Grow or shrink the worker pool from how much time workers stall on I/O" << std::endl;
+    std::cerr << "  --walkers N        Walk the directory tree with N threads (default 1)" << std::endl;
+    std::cerr << "  --fused            Walk and search in one work-stealing pool (no file channel)" << std::endl;
+    std::cerr << "  --io-depth N       Read up to N files ahead of the workers (io_uring, or N reader threads)" << std::endl;
+    std::cerr << "  --no-io-uring      Read ahead with threads even where io_uring is available" << std::endl;
+    std::cerr << "  --format FORMAT    Print matches as 'verbose' blocks (default) or 'compact' lines" << std::endl;
+    std::cerr << "  --sort             Print files in the order they are walked, the same on every run" << std::endl;
+    std::cerr << "  --index FILE       Trigram index to build or use (default <directory>/.search-index)" << std::endl;
+    std::cerr << "  --no-index         Search every file even if an index exists" << std::endl;
+    std::cerr << "  --manifest FILE    Reuse and update per-file results kept in FILE" << std::endl;
+    std::cerr << "  --                 Treat every following argument as positional" << std::endl;
+}
+
+bool parseOptions(int argc, char* argv[], SearchOptions& options) {
+    std::vector<std::string> positional;
+    int first = 1;
+    if (argc > 1 && std::string(argv[1]) == "index") {
+        options.build_index = true;
+        first = 2;
+    }
+    bool flagsDone = false;
+    bool patternFlag = false; // -f may add no patterns, but still replaces the target
+    for (int i = first; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!flagsDone && arg == "--") {
+            flagsDone = true;
+        } else if (!flagsDone && ((arg.size() > 2 && arg.compare(0, 2, "--") == 0) || shortFlagName(arg))) {
+            // "--flag=value" carries its value inline, otherwise it is the next argument
+            std::string name = arg;
+            if (const char* longName = shortFlagName(arg)) name = longName;
+            std::string value;
+            bool inlineValue = false;
+            bool tookValue = false;
+            std::size_t eq = arg.find('=');
+            if (eq != std::string::npos) {
+                name = arg.substr(0, eq);
+                value = arg.substr(eq + 1);
+                inlineValue = true;
+            }
+            auto takeValue = [&]() {
+                tookValue = true;
+                if (inlineValue) return true;
+                if (i + 1 >= argc) return false;
+                value = argv[++i];
+                return true;
+            };
+
+            if (name == "--pattern") {
+                if (!takeValue()) {
+                    std::cerr << "--pattern needs a value" << std::endl;
+                    return false;
+                }
+                options.patterns.push_back(value);
+            } else if (name == "--pattern-file") {
+                if (!takeValue() || !readPatternFile(value, options.patterns)) {
+                    std::cerr << "--pattern-file needs a readable file" << std::endl;
+                    return false;
+                }
+                patternFlag = true;
+            } else if (name == "--regex") {
+                options.syntax = patternSyntax::regex;
+            } else if (name == "--ignore-case") {
+                options.match_options.ignore_case = true;
+            } else if (name == "--word-regexp") {
+                options.match_options.whole_word = true;
+            } else if (name == "--invert-match") {
+                options.match_options.invert = true;
+            } else if (name == "--files-with-matches") {
+                options.report_mode = reportMode::files;
+            } else if (name == "--count") {
+                options.report_mode = reportMode::counts;
+            } else if (name == "--max-count") {
+                if (!takeValue() || !parseCount(value, options.max_count)) {
+                    std::cerr << "--max-count needs a line count greater than 0" << std::endl;
+                    return false;
+                }
+            } else if (name == "--text") {
+                options.search_binary = true;
+            } else if (name == "--max-filesize") {
+                if (!takeValue() || !parseSize(value, options.max_file_size)) {
+                    std::cerr << "--max-filesize needs a size greater than 0, such as 500K or 20M" << std::endl;
+                    return false;
+                }
+            } else if (name == "--include" || name == "--exclude") {
+                if (!takeValue() || value.empty()) {
+                    std::cerr << name << " needs a glob" << std::endl;
+                    return false;
+                }
+                (name == "--include" ? options.include_globs : options.exclude_globs).push_back(value);
+            } else if (name == "--no-ignore") {
+                options.use_gitignore = false;
+            } else if (name == "--stats") {
+                options.stats = true;
+            } else if (name == "--lock-free") {
+                options.channel_kind = channelKind::lockFree;
+            } else if (name == "--fused") {
+                options.fused = true;
+            } else if (name == "--threads") {
+                if (!takeValue() || !parseCount(value, options.threads)) {
+                    std::cerr << "--threads needs a thread count greater than 0" << std::endl;
+                    return false;
+                }
+            } else if (name == "--pin") {
+                options.pin_threads = true;
+            } else if (name == "--numa") {
+                options.numa_groups = true;
+            } else if (name == "--adaptive") {
+                options.adaptive_pool = true;
+            } else if (name == "--walkers") {
+                if (!takeValue() || !parseCount(value, options.walker_threads)) {
+                    std::cerr << "--walkers needs a thread count greater than 0" << std::endl;
+                    return false;
+                }
+            } else if (name == "--io-depth") {
+                if (!takeValue() || !parseCount(value, options.io_depth)) {
+                    std::cerr << "--io-depth needs a file count greater than 0" << std::endl;
+                    return false;
+                }
+            } else if (name == "--no-io-uring") {
+                options.io_uring = false;
+            } else if (name == "--format") {
+                if (!takeValue()) {
+                    std::cerr << "--format needs a value" << std::endl;
+                    return false;
+                }
+                if (value == "verbose") {
+                    options.format = outputFormat::verbose;
+                } else if (value == "compact") {
+                    options.format = outputFormat::compact;
+                } else {
+                    std::cerr << "Unknown output format: " << value << std::endl;
+                    return false;
+                }
+            } else if (name == "--sort") {
+                options.sort_output = true;
+            } else if (name == "--index") {
+                if (!takeValue() || value.empty()) {
+                    std::cerr << "--index needs a file name" << std::endl;
+                    return false;
+                }
+                options.index_path = value;
+            } else if (name == "--no-index") {
+                options.use_index = false;
+            } else if (name == "--manifest") {
+                if (!takeValue() || value.empty()) {
+                    std::cerr << "--manifest needs a file name" << std::endl;
+                    return false;
+                }
+                options.manifest_path = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+            // A flag that takes no value is not spelled with one, so --sort=false is an error
+            if (inlineValue && !tookValue) {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    // With -e/-f (and for the index subcommand) the only positional is the directory
+    if (options.build_index || patternFlag || !options.patterns.empty()) {
+        if (positional.size() > 1) {
+            return false;
+        }
+        if (!options.build_index && options.patterns.empty()) {
+            std::cerr << "No patterns to search for" << std::endl;
+            return false;
+        }
+    } else {
+        if (positional.empty() || positional.size() > 2) {
+            return false;
+        }
+        options.patterns.push_back(positional[0]);
+        positional.erase(positional.begin());
+    }
+    options.root_dir = positional.empty()
+        ? std::filesystem::current_path()
+        : std::filesystem::path(positional[0]);
+    if (options.index_path.empty()) {
+        options.index_path = options.root_dir / DEFAULT_INDEX_NAME;
+    }
+    return true;
+}
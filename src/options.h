@@ -0,0 +1,126 @@
+/**
+ * @file src/options.h
+ *
+ * @brief Declaration of the command-line options for the search program.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of the SearchOptions structure that
+ * holds everything parsed from the command line, and the parseOptions
+ * function that fills it in. Flags start with "--" and may appear anywhere;
+ * flags that take a value accept both "--flag value" and "--flag=value",
+ * and flags that take none reject "=value".
+ * The remaining arguments are the target text and the optional directory;
+ * "--" ends the flags, so a target starting with "--" can still be given.
+ * Patterns given with -e or read from a file with -f replace the target
+ * argument; -E makes every pattern a regular expression. -i, -w and -v
+ * ignore case, match whole words only and invert the match. -l and -c
+ * report only the matching files or their match counts, and --max-count
+ * stops searching a file after that many matching lines. Files that look
+ * binary are skipped unless -a is given, and --max-filesize skips large files.
+ * --include and --exclude globs pick the files and directories to walk, and
+ * .gitignore files are honoured unless --no-ignore is given. --stats prints
+ * per-stage counters and timings at the end of the run.
+ * "index" as the first argument selects the index subcommand, which takes
+ * only the optional directory.
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "channel.h"
+#include "match.h"
+#include "matcher.h"
+#include "output_writer.h"
+#include "trigram_index.h"
+
+/**
+ * @struct SearchOptions
+ *
+ * @brief Settings for one run of the search program
+ *
+ * @var patterns The texts to search for; a line matches if it contains any of them
+ * @var syntax Whether the patterns are literal text or regular expressions
+ * @var match_options Case folding, whole-word and inverted matching
+ * @var root_dir The directory to search (defaults to the current directory)
+ * @var channel_kind Which buffered channel implementation to use
+ * @var threads Search threads to start with (0 = one per hardware thread, at least 2)
+ * @var pin_threads Pin each search thread to one CPU
+ * @var numa_groups Split the search threads into one group per NUMA node, each with its own file channel
+ * @var adaptive_pool Grow or shrink the worker pool while searching
+ * @var walker_threads Threads walking the directory tree (1 = single producer)
+ * @var fused Walk and search in one work-stealing pool instead of the pipeline
+ * @var io_depth Files the read-ahead stage keeps opening or reading at once (0 = no read-ahead)
+ * @var io_uring Let the read-ahead stage use io_uring where the kernel allows it
+ * @var format How matches are printed
+ * @var sort_output Print files in traversal order (single producer and the pipeline)
+ * @var report_mode Print matching lines, matching files (-l) or match counts (-c)
+ * @var max_count Matching lines to report per file (0 = no limit)
+ * @var search_binary Search files that look binary instead of skipping them
+ * @var max_file_size Skip files larger than this many bytes (0 = no limit)
+ * @var include_globs Only search files matching one of these (empty = default extensions)
+ * @var exclude_globs Skip files and directories matching any of these
+ * @var use_gitignore Honour .gitignore files and skip .git directories
+ * @var stats Collect per-thread counters and print a report at the end
+ * @var build_index Build the trigram index instead of searching
+ * @var index_path Index file to build or use (defaults to DEFAULT_INDEX_NAME in root_dir)
+ * @var use_index Consult the index when searching, if one exists
+ * @var manifest_path Manifest of per-file results to reuse and update (empty = none)
+ */
+struct SearchOptions {
+    std::vector<std::string> patterns;
+    patternSyntax syntax = patternSyntax::literal;
+    MatchOptions match_options;
+    std::filesystem::path root_dir;
+    channelKind channel_kind = channelKind::locked;
+    unsigned int threads = 0;
+    bool pin_threads = false;
+    bool numa_groups = false;
+    bool adaptive_pool = false;
+    unsigned int walker_threads = 1;
+    bool fused = false;
+    unsigned int io_depth = 0;
+    bool io_uring = true;
+    outputFormat format = outputFormat::verbose;
+    bool sort_output = false;
+    reportMode report_mode = reportMode::lines;
+    unsigned int max_count = 0;
+    bool search_binary = false;
+    std::uintmax_t max_file_size = 0;
+    std::vector<std::string> include_globs;
+    std::vector<std::string> exclude_globs;
+    bool use_gitignore = true;
+    bool stats = false;
+    bool build_index = false;
+    std::filesystem::path index_path;
+    bool use_index = true;
+    std::filesystem::path manifest_path;
+};
+
+/**
+ * @brief Parse the command line into a SearchOptions
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @param options The options to fill in
+ *
+ * @return true if the arguments were valid, false otherwise
+ *
+ * @details On failure a message is written to std::cerr; the caller should
+ * print the usage text and exit.
+ */
+bool parseOptions(int argc, char* argv[], SearchOptions& options);
+
+/**
+ * @brief Print the usage text to std::cerr
+ */
+void printUsage();
+
+#endif // OPTIONS_H
@@ -0,0 +1,111 @@
+/**
+ * @file src/output_writer.cpp
+ *
+ * @brief Implementation of the buffered OutputWriter.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of OutputWriter. The buffer's
+ * storage is reserved once up front and reused after every flush, so
+ * steady-state printing does not allocate.
+ */
+
+#include "output_writer.h"
+#include <unistd.h>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+OutputWriter::OutputWriter(int fd, std::size_t capacity, std::chrono::milliseconds maxDelay)
+    : fd(fd), capacity(capacity > 0 ? capacity : 1), maxDelay(maxDelay) {
+    buffer.reserve(this->capacity);
+}
+
+OutputWriter::~OutputWriter() {
+    flush();
+}
+
+/**
+ * @brief Append bytes, writing the buffer out first if they do not fit
+ */
+void OutputWriter::write(const char* data, std::size_t n) {
+    if (buffer.size() + n > capacity) {
+        flush();
+        if (n >= capacity) {
+            writeAll(data, n);
+            return;
+        }
+    }
+    noteFirstByte();
+    buffer.insert(buffer.end(), data, data + n);
+}
+
+void OutputWriter::write(char c) {
+    if (buffer.size() + 1 > capacity) {
+        flush();
+    }
+    noteFirstByte();
+    buffer.push_back(c);
+}
+
+void OutputWriter::writeNumber(long long n) {
+    char digits[24];
+    std::to_chars_result res = std::to_chars(digits, digits + sizeof(digits), n);
+    write(digits, static_cast<std::size_t>(res.ptr - digits));
+}
+
+/**
+ * @brief How long until buffered output must be written
+ *
+ * @return zero if the buffer is empty or already overdue
+ */
+std::chrono::steady_clock::duration OutputWriter::timeUntilFlush() const {
+    if (buffer.empty()) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    std::chrono::steady_clock::duration left = oldest + maxDelay - std::chrono::steady_clock::now();
+    return left > std::chrono::steady_clock::duration::zero() ? left : std::chrono::steady_clock::duration::zero();
+}
+
+void OutputWriter::flushIfDue() {
+    if (!buffer.empty() && std::chrono::steady_clock::now() - oldest >= maxDelay) {
+        flush();
+    }
+}
+
+void OutputWriter::flush() {
+    if (!buffer.empty()) {
+        writeAll(buffer.data(), buffer.size());
+        buffer.clear(); // keeps the reserved storage
+    }
+}
+
+/**
+ * @brief write() until every byte is out, retrying short writes and EINTR
+ */
+void OutputWriter::writeAll(const char* data, std::size_t n) {
+    while (n > 0 && !failed) {
+        ssize_t written = ::write(fd, data, n);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            failed = true;
+            std::cerr << "Error writing output: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        data += written;
+        n -= static_cast<std::size_t>(written);
+    }
+}
+
+/**
+ * @brief Start the flush-delay clock when the buffer goes from empty to non-empty
+ */
+void OutputWriter::noteFirstByte() {
+    if (buffer.empty()) {
+        oldest = std::chrono::steady_clock::now();
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * @file src/output_writer.h
+ *
+ * @brief Declaration of a buffered writer for the printer's output.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of the OutputWriter class and the
+ * outputFormat setting. The printer formats matches into one large reusable
+ * buffer instead of going through std::cout with std::endl, which flushes
+ * on every line. The buffer is handed to write() only when it fills up, when
+ * the oldest unwritten byte has waited longer than the flush delay, or when
+ * the writer is flushed or destroyed.
+ */
+
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief How each match is printed
+ *
+ * @details verbose is the original five-line block per match; compact is one
+ * "path:line:content" line per match, in the style of grep -n.
+ */
+enum class outputFormat{ verbose, compact };
+
+/**
+ * @class OutputWriter
+ *
+ * @brief Buffered, single-threaded writer to a file descriptor
+ *
+ * @details Only the printer thread writes, so no locking is needed; the cost
+ * of the system call is spread over as many matches as fit in the buffer.
+ * Writes larger than the buffer bypass it. If a write fails (for example the
+ * reader of a pipe went away) the error is reported once on std::cerr and all
+ * further output is dropped.
+ */
+class OutputWriter {
+public:
+    // Bytes buffered before a write is forced
+    static constexpr std::size_t DEFAULT_CAPACITY = 1 << 20;
+    // Longest time output may sit in the buffer
+    static constexpr std::chrono::milliseconds DEFAULT_MAX_DELAY{100};
+
+    explicit OutputWriter(
+        int fd,
+        std::size_t capacity = DEFAULT_CAPACITY,
+        std::chrono::milliseconds maxDelay = DEFAULT_MAX_DELAY
+    );
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    void write(const char* data, std::size_t n);
+    void write(const char* text) { write(text, std::strlen(text)); }
+    void write(std::string_view text) { write(text.data(), text.size()); }
+    void write(char c);
+    void writeNumber(long long n);
+
+    bool empty() const { return buffer.empty(); }
+    std::chrono::steady_clock::duration timeUntilFlush() const;
+    void flushIfDue();
+    void flush();
+
+private:
+    void writeAll(const char* data, std::size_t n);
+    void noteFirstByte();
+
+    int fd;
+    std::size_t capacity;
+    std::chrono::milliseconds maxDelay;
+    std::vector<char> buffer;
+    std::chrono::steady_clock::time_point oldest;
+    bool failed = false;
+};
+
+#endif // OUTPUT_WRITER_H
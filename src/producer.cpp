@@ -10,16 +10,19 @@
  * @section Overview
  * 
  * This file contains the implementation of the producer thread function
- * that recursively traverses a specified root directory, checks for files
- * with valid extensions, and sends their paths through a provided channel.
+ * that recursively traverses a specified root directory, checks each file
+ * against the walk rules, and sends their paths through a provided channel.
  * Once the traversal is complete, the channel is closed to signal that no
  * more files will be sent.
  */
 
 #include "producer.h"
+#include "search_stats.h"
 #include <iostream>
 #include <filesystem>
 #include <set> 
+#include <vector>
+#include <utility>
 
 /**
  * @brief Check if the file has a valid extension
@@ -32,7 +35,7 @@
  * it checks to see if the file's extension is in the predefined set. If it is not,
  * the file is considered invalid.
  */
-static bool hasValidExtension(const std::filesystem::path& p) {
+bool hasValidExtension(const std::filesystem::path& p) {
     static const std::set<std::string> validExtensions = {
         ".cc", ".c", ".cpp", ".h", ".hpp", ".pl", ".sh", ".py", ".txt"
     };
@@ -42,31 +45,92 @@ static bool hasValidExtension(const std::filesystem::path& p) {
 
 
 /**
- * @brief Producer thread function to traverse directories and send file paths
+ * @brief Producer thread function to traverse directories and send file tasks
  * 
  * @param rootDir The root directory to start traversal
- * @param fileChan The channel to send file paths through
+ * @param fileChan The channel to send file tasks through
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Files this rules out are not sent; nullptr sends every file
+ * @param order Numbers the files and paces the walk for --sort; nullptr leaves them unnumbered
  * 
  * @return void
  * 
  * @details This function recursively traverses the directory tree starting from
- * the specified root directory. It checks each file's extension against a set of
- * valid extensions. If a file has a valid extension, its path is sent through the
- * provided channel. Once the traversal is complete, the channel is closed to signal
- * that no more files will be sent.
+ * the specified root directory. Directories the walk rules reject are pruned
+ * with disable_recursion_pending(), so nothing below them is listed. The
+ * .gitignore scope of each open directory is kept in a stack indexed by the
+ * iterator depth. Each file the rules accept becomes one FileTask, or
+ * several chunk tasks if it is larger than SPLIT_CHUNK_SIZE (see appendFileTasks).
+ * Tasks are collected into batches of PRODUCER_BATCH_SIZE and sent through the provided channel with one sendBatch call
+ * per batch. Once the traversal is complete, the last partial batch is sent and the
+ * channel is closed to signal that no more files will be sent. With an order
+ * window each file gets the next sequence number, and the walk waits (after
+ * sending its partial batch) whenever it gets too far ahead of the printer.
  */
 void producerThreadFunc(
     const std::filesystem::path& rootDir,
-    channel<std::filesystem::path>* fileChan
+    channel<FileTask>* fileChan,
+    const WalkRules& rules,
+    const FileFilter* filter,
+    ReorderWindow* order
 ) {
+    StatsScope statsScope("walker");
+    ThreadStats* stats = threadStats();
+    std::vector<FileTask> batch;
+    batch.reserve(PRODUCER_BATCH_SIZE);
+    std::uint64_t nextSequence = 0;
     try {
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(rootDir)) {
-            if (entry.is_regular_file() && hasValidExtension(entry.path())) {
-                fileChan->send(entry.path());
+        // scopes[d] is the scope of the directory whose entries are at depth d
+        std::vector<WalkRules::Scope> scopes{rules.enter(nullptr, rootDir)};
+        std::filesystem::recursive_directory_iterator it(rootDir);
+        const std::filesystem::recursive_directory_iterator end;
+        for (; it != end; ++it) {
+            const std::filesystem::directory_entry& entry = *it;
+            scopes.resize(static_cast<std::size_t>(it.depth()) + 1);
+            if (entry.is_directory() && !entry.is_symlink()) {
+                if (!rules.walkDirectory(scopes.back(), entry)) {
+                    it.disable_recursion_pending();
+                } else {
+                    WalkRules::Scope inner = rules.enter(scopes.back(), entry.path());
+                    scopes.push_back(std::move(inner));
+                }
+            } else if (entry.is_regular_file()) {
+                if (stats) ++stats->files_walked;
+                if (!rules.searchFile(scopes.back(), entry) || (filter && !filter->mustSearch(entry))) {
+                    continue;
+                }
+                // The size comes from the directory scan; 0 if it cannot be read
+                std::error_code sizeEc;
+                std::uintmax_t size = entry.file_size(sizeEc);
+                std::uint64_t sequence = NO_SEQUENCE;
+                if (order) {
+                    sequence = nextSequence++;
+                    if (!order->admits(sequence)) {
+                        // The printer may be waiting for a file still in this batch
+                        StatsTimer timer(&ThreadStats::file_send_wait);
+                        if (!batch.empty()) {
+                            fileChan->sendBatch(std::move(batch));
+                            batch.clear();
+                        }
+                        order->waitFor(sequence);
+                    }
+                }
+                appendFileTasks(entry.path(), sizeEc ? 0 : size, batch, sequence);
+                if (stats) ++stats->files_sent;
+                if (batch.size() >= PRODUCER_BATCH_SIZE) {
+                    StatsTimer timer(&ThreadStats::file_send_wait);
+                    fileChan->sendBatch(std::move(batch));
+                    batch.clear();
+                }
             }
         }
     } catch (const std::exception& e) {
         std::cerr << "Error during directory traversal: " << e.what() << std::endl;
     }
+    // Whatever is left over from the last partial batch
+    if (!batch.empty()) {
+        StatsTimer timer(&ThreadStats::file_send_wait);
+        fileChan->sendBatch(std::move(batch));
+    }
     fileChan->close();
 }
\ No newline at end of file
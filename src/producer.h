@@ -10,8 +10,8 @@
  * @section Overview
  * 
  * This file contains the declaration of the producer thread function
- * that recursively traverses a specified root directory, checks for files
- * with valid extensions, and sends their paths through a provided channel.
+ * that recursively traverses a specified root directory, checks each file
+ * against the walk rules, and sends their paths through a provided channel.
  * Once the traversal is complete, the channel is closed to signal that no
  * more files will be sent.
  */
@@ -22,6 +22,13 @@
 #include <string>
 #include <filesystem>
 #include "channel.h"
+#include "file_task.h"
+#include "file_filter.h"
+#include "reorder.h"
+#include "walk_rules.h"
+
+// Number of tasks handed to the file channel per sendBatch call
+constexpr std::size_t PRODUCER_BATCH_SIZE = 32;
 
 /**
  * @brief Check if the file has a valid extension
@@ -34,25 +41,37 @@
  * it checks to see if the file's extension is in the predefined set. If it is not,
  * the file is considered invalid.
  */
-static bool hasValidExtension(const std::filesystem::path& p);
+bool hasValidExtension(const std::filesystem::path& p);
 
 /**
- * @brief Producer thread function to traverse directories and send file paths
+ * @brief Producer thread function to traverse directories and send file tasks
  * 
  * @param rootDir The root directory to start traversal
- * @param fileChan The channel to send file paths through
+ * @param fileChan The channel to send file tasks through
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Files this rules out are not sent; nullptr sends every file
+ * @param order Numbers the files and paces the walk for --sort; nullptr leaves them unnumbered
  * 
  * @return void
  * 
  * @details This function recursively traverses the directory tree starting from
- * the specified root directory. It checks each file's extension against a set of
- * valid extensions. If a file has a valid extension, its path is sent through the
- * provided channel. Once the traversal is complete, the channel is closed to signal
- * that no more files will be sent.
+ * the specified root directory. Directories the walk rules reject are pruned
+ * with disable_recursion_pending(), so nothing below them is listed. The
+ * .gitignore scope of each open directory is kept in a stack indexed by the
+ * iterator depth. Each file the rules accept becomes one FileTask, or
+ * several chunk tasks if it is larger than SPLIT_CHUNK_SIZE (see appendFileTasks).
+ * Tasks are collected into batches of PRODUCER_BATCH_SIZE and sent through the provided channel with one sendBatch call
+ * per batch. Once the traversal is complete, the last partial batch is sent and the
+ * channel is closed to signal that no more files will be sent. With an order
+ * window each file gets the next sequence number, and the walk waits (after
+ * sending its partial batch) whenever it gets too far ahead of the printer.
  */
 void producerThreadFunc(
     const std::filesystem::path& rootDir,
-    channel<std::filesystem::path>* fileChan
+    channel<FileTask>* fileChan,
+    const WalkRules& rules,
+    const FileFilter* filter,
+    ReorderWindow* order = nullptr
 );
 
 #endif // PRODUCER_H
\ No newline at end of file
@@ -0,0 +1,399 @@
+/**
+ * @file src/read_ahead.cpp
+ *
+ * @brief Implementation of the read-ahead stage, over io_uring or reader threads.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains IoRing, a minimal wrapper over the io_uring system calls
+ * (there is no liburing dependency), the single-threaded read-ahead loop that
+ * uses it, and the reader-thread fallback. Every file slot of the loop goes
+ * through openat, one or more reads into a buffer sized from the walked file
+ * size, and a close; the slot is then reused for the next file.
+ */
+
+#include "read_ahead.h"
+#include "search_stats.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+// Bytes read past the walked size, so a file that grew since the walk is noticed
+constexpr std::size_t READ_SLACK = 4096;
+
+/**
+ * @brief Pass a task on to the workers
+ */
+static void forward(channel<FileTask>* out, FileTask&& task) {
+    if (ThreadStats* stats = threadStats()) ++stats->files_sent;
+    StatsTimer timer(&ThreadStats::file_send_wait);
+    out->send(std::move(task));
+}
+
+/**
+ * @brief Body of one fallback reader thread
+ *
+ * @details Reads each whole file with plain blocking reads, so the number of
+ * reader threads is the number of files being read at once.
+ */
+static void readerThreadFunc(channel<FileTask>* in, channel<FileTask>* out) {
+    StatsScope statsScope("reader");
+    FileTask task;
+    while (true) {
+        {
+            StatsTimer timer(&ThreadStats::file_receive_wait);
+            if (!in->receive(task)) {
+                break;
+            }
+        }
+        if (!task.split) {
+            auto file = std::make_shared<FileBuffer>(task.path, false);
+            if (file->isOpen()) {
+                task.contents = std::move(file);
+            }
+        }
+        forward(out, std::move(task));
+        task = FileTask();
+    }
+}
+
+#ifdef HAVE_IO_URING
+
+/**
+ * @class IoRing
+ *
+ * @brief One io_uring instance: its submission and completion rings
+ *
+ * @details Only one thread uses a ring. next() hands out a cleared submission
+ * entry, submitAndWait() submits everything handed out since the last call
+ * and waits for at least one completion, and reap() calls back for each
+ * completion with its user_data and result.
+ */
+class IoRing {
+public:
+    IoRing() = default;
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    bool setup(unsigned int entries);
+    io_uring_sqe* next();
+    bool submitAndWait();
+
+    template <class OnComplete>
+    void reap(OnComplete onComplete) {
+        unsigned int head = *cqHead;
+        unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            std::uint64_t user = cqe.user_data;
+            int result = cqe.res;
+            ++head;
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+            onComplete(user, result);
+            tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        }
+    }
+
+private:
+    int fd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    std::size_t sqRingSize = 0;
+    std::size_t cqRingSize = 0;
+    io_uring_sqe* sqes = nullptr;
+    std::size_t sqesSize = 0;
+    unsigned int* sqHead = nullptr;
+    unsigned int* sqTail = nullptr;
+    unsigned int* sqArray = nullptr;
+    unsigned int sqMask = 0;
+    unsigned int sqEntries = 0;
+    unsigned int* cqHead = nullptr;
+    unsigned int* cqTail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned int cqMask = 0;
+    unsigned int unsubmitted = 0;
+};
+
+/**
+ * @brief Create the ring and map its queues
+ *
+ * @return false if io_uring is unavailable, for example on an old kernel or
+ * when a sandbox forbids it
+ */
+bool IoRing::setup(unsigned int entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+    sqRing = ::mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = nullptr;
+        return false;
+    }
+    if (singleMap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = ::mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            cqRing = nullptr;
+            return false;
+        }
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* entriesMap = ::mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (entriesMap == MAP_FAILED) {
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(entriesMap);
+
+    char* sq = static_cast<char*>(sqRing);
+    sqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    char* cq = static_cast<char*>(cqRing);
+    cqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    cqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    return true;
+}
+
+IoRing::~IoRing() {
+    if (sqes) ::munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+    if (sqRing) ::munmap(sqRing, sqRingSize);
+    if (fd >= 0) ::close(fd);
+}
+
+/**
+ * @brief A cleared submission entry, or nullptr if the queue is full
+ *
+ * @details The entry is published to the kernel right away, so it must be
+ * filled in before the next call to submitAndWait().
+ */
+io_uring_sqe* IoRing::next() {
+    unsigned int tail = *sqTail;
+    if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+        return nullptr;
+    }
+    unsigned int index = tail & sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++unsubmitted;
+    return sqe;
+}
+
+/**
+ * @brief Submit the pending entries and wait for at least one completion
+ *
+ * @return false on an unexpected error from the kernel
+ */
+bool IoRing::submitAndWait() {
+    while (true) {
+        long done = ::syscall(__NR_io_uring_enter, fd, unsubmitted, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (done >= 0) {
+            unsubmitted -= static_cast<unsigned int>(done);
+            return true;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @struct ReadSlot
+ *
+ * @brief One file being opened or read by the ring
+ */
+struct ReadSlot {
+    enum class step { idle, opening, reading };
+
+    step state = step::idle;
+    FileTask task;
+    std::vector<char> buffer;
+    std::size_t filled = 0;
+    int fd = -1;
+};
+
+/**
+ * @brief Queue the next read of a slot's file into the rest of its buffer
+ */
+static void queueRead(IoRing& ring, ReadSlot& slot, std::uint64_t index) {
+    io_uring_sqe* sqe = ring.next();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = slot.fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(slot.buffer.data() + slot.filled);
+    sqe->len = static_cast<std::uint32_t>(slot.buffer.size() - slot.filled);
+    sqe->off = slot.filled;
+    sqe->user_data = index;
+    slot.state = ReadSlot::step::reading;
+}
+
+/**
+ * @brief The read-ahead loop over io_uring
+ *
+ * @return false if no ring could be set up; nothing has been read from in then
+ *
+ * @details New tasks are only waited for when nothing is in flight; while
+ * reads are outstanding the loop takes whatever tasks are already queued and
+ * otherwise waits on the ring. Each completion moves its slot to the next
+ * step, and a finished file is forwarded right away.
+ */
+static bool ringReadAhead(channel<FileTask>* in, channel<FileTask>* out, unsigned int depth) {
+    IoRing ring;
+    if (!ring.setup(depth)) {
+        return false;
+    }
+    StatsScope statsScope("reader");
+
+    std::vector<ReadSlot> slots(depth);
+    std::vector<std::uint64_t> idle;
+    for (std::uint64_t i = depth; i > 0; --i) {
+        idle.push_back(i - 1);
+    }
+
+    // Close the file and send the task on, with its contents if the read worked
+    auto finish = [&](std::uint64_t index, bool ok) {
+        ReadSlot& slot = slots[index];
+        if (slot.fd >= 0) {
+            ::close(slot.fd);
+            slot.fd = -1;
+        }
+        // A full buffer means the file grew after the walk; let the worker read it
+        if (ok && slot.filled < slot.buffer.size()) {
+            slot.buffer.resize(slot.filled);
+            slot.task.contents = std::make_shared<FileBuffer>(std::move(slot.buffer));
+        }
+        forward(out, std::move(slot.task));
+        slot = ReadSlot();
+        idle.push_back(index);
+    };
+
+    bool inputOpen = true;
+    while (true) {
+        while (inputOpen && !idle.empty()) {
+            FileTask task;
+            if (idle.size() == slots.size()) {
+                StatsTimer timer(&ThreadStats::file_receive_wait);
+                if (!in->receive(task)) {
+                    inputOpen = false;
+                    break;
+                }
+            } else {
+                std::optional<FileTask> queued = in->tryReceive();
+                if (!queued) break;
+                task = std::move(*queued);
+            }
+            if (task.split) {
+                forward(out, std::move(task));
+                continue;
+            }
+
+            std::uint64_t index = idle.back();
+            idle.pop_back();
+            ReadSlot& slot = slots[index];
+            slot.task = std::move(task);
+            slot.buffer.resize(static_cast<std::size_t>(slot.task.file_size) + READ_SLACK);
+            io_uring_sqe* sqe = ring.next();
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = reinterpret_cast<std::uint64_t>(slot.task.path.c_str());
+            sqe->open_flags = O_RDONLY | O_CLOEXEC;
+            sqe->user_data = index;
+            slot.state = ReadSlot::step::opening;
+        }
+        if (idle.size() == slots.size()) {
+            if (!inputOpen) break;
+            continue;
+        }
+
+        if (!ring.submitAndWait()) {
+            // The ring broke: send everything on unread and finish with threads
+            for (std::uint64_t i = 0; i < slots.size(); ++i) {
+                if (slots[i].state != ReadSlot::step::idle) finish(i, false);
+            }
+            return false;
+        }
+        ring.reap([&](std::uint64_t index, int result) {
+            ReadSlot& slot = slots[index];
+            if (result < 0) {
+                finish(index, false);
+            } else if (slot.state == ReadSlot::step::opening) {
+                slot.fd = result;
+                queueRead(ring, slot, index);
+            } else {
+                slot.filled += static_cast<std::size_t>(result);
+                if (result == 0 || slot.filled == slot.buffer.size()) {
+                    finish(index, true);
+                } else {
+                    queueRead(ring, slot, index); // short read
+                }
+            }
+        });
+    }
+    return true;
+}
+
+#endif // HAVE_IO_URING
+
+void readAheadFunc(
+    channel<FileTask>* in,
+    channel<FileTask>* out,
+    unsigned int depth,
+    bool useIoUring
+) {
+    if (depth == 0) depth = 1;
+    bool done = false;
+#ifdef HAVE_IO_URING
+    if (useIoUring) {
+        done = ringReadAhead(in, out, depth);
+    }
+#else
+    (void)useIoUring;
+#endif
+    if (!done) {
+        std::vector<std::thread> readers;
+        readers.reserve(depth);
+        for (unsigned int i = 0; i < depth; ++i) {
+            readers.emplace_back(readerThreadFunc, in, out);
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+    }
+    out->close();
+}
@@ -0,0 +1,55 @@
+/**
+ * @file src/read_ahead.h
+ *
+ * @brief Declaration of the stage that reads files ahead of the search workers.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of readAheadFunc, an optional stage
+ * between the file channel and the worker pool (--io-depth). Without it each
+ * worker opens and faults in one file at a time, so on a cold cache or a
+ * network filesystem the only way to have more I/O in flight is to start more
+ * workers. The stage keeps up to a fixed number of opens and reads
+ * outstanding on its own, independent of the worker count, and hands each
+ * file to the workers with its bytes already in memory.
+ *
+ * On Linux the reads go through io_uring, driven directly through its system
+ * calls: one thread submits openat and read requests for many files and
+ * forwards each file as its read completes. Where io_uring is missing or not
+ * permitted the stage falls back to as many reader threads doing plain
+ * blocking reads.
+ */
+
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#include "channel.h"
+#include "file_task.h"
+
+/**
+ * @brief Read files from one channel and pass them on, with their contents, to another
+ *
+ * @param in The file channel the producer fills
+ * @param out The channel the workers read; closed once in is closed and drained
+ * @param depth How many files to have opening or reading at once
+ * @param useIoUring Try io_uring first; false always uses reader threads
+ *
+ * @return void
+ *
+ * @details Only whole-file tasks are read; chunks of large files are passed
+ * on untouched and mapped by the workers as before, which also bounds the
+ * memory held by read-ahead to depth files of at most SPLIT_CHUNK_SIZE each,
+ * plus those waiting in out. A file that fails to open or read here is
+ * passed on without contents, and the worker tries it again the usual way.
+ */
+void readAheadFunc(
+    channel<FileTask>* in,
+    channel<FileTask>* out,
+    unsigned int depth,
+    bool useIoUring
+);
+
+#endif // READ_AHEAD_H
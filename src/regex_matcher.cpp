@@ -0,0 +1,928 @@
+/**
+ * @file src/regex_matcher.cpp
+ *
+ * @brief Implementation of the regular-expression matcher built on a lazy DFA.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the pattern parser, the Thompson construction that
+ * turns the syntax tree into an NFA, and the lazy DFA that runs it. A DFA
+ * state is the sorted set of NFA states reachable at a position; its
+ * transitions start out unknown and are filled in the first time the scan
+ * takes them, so only the states a search actually visits are ever built.
+ * Transitions are indexed by byte class (bytes no pattern tells apart share
+ * a class), which keeps a state's row short. Each thread has its own cache
+ * of states; when it outgrows its budget it is thrown away and the scan
+ * continues from a fresh copy of the current state.
+ *
+ * The search is unanchored and line based: every step adds the NFA start
+ * again, so a match may begin at any byte, and the scan restarts from the
+ * line-start state after each newline. "^" is only followed at the start of
+ * a line and "$" only when the scan reaches the end of one.
+ */
+
+#include "regex_matcher.h"
+#include "aho_corasick.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+// Limits that keep a hostile pattern from exhausting memory
+constexpr int MAX_REPEAT = 1000;
+constexpr int MAX_NESTING = 1000;
+constexpr std::size_t MAX_NFA_STATES = 1 << 20;
+
+// Shorter required literals match too often to be worth a prefilter pass
+constexpr std::size_t MIN_PREFILTER_LENGTH = 2;
+
+/**
+ * @struct Node
+ *
+ * @brief One node of a parsed pattern
+ *
+ * @details A set matches one byte from bytes; concat and alt combine their
+ * kids; repeat matches its only kid between min and max times (max -1 means
+ * unbounded); bol and eol are the "^" and "$" anchors; empty matches the
+ * empty string.
+ */
+struct Node {
+    enum class kind { set, concat, alt, repeat, bol, eol, empty };
+
+    explicit Node(kind type) : type(type) {}
+
+    kind type;
+    std::bitset<256> bytes;
+    std::vector<std::unique_ptr<Node>> kids;
+    int min = 0;
+    int max = 0;
+};
+
+std::unique_ptr<Node> makeNode(Node::kind type) {
+    return std::unique_ptr<Node>(new Node(type));
+}
+
+std::unique_ptr<Node> makeSet(const std::bitset<256>& bytes) {
+    std::unique_ptr<Node> node = makeNode(Node::kind::set);
+    node->bytes = bytes;
+    return node;
+}
+
+std::bitset<256> rangeSet(int from, int to) {
+    std::bitset<256> bytes;
+    for (int c = from; c <= to; ++c) bytes.set(c);
+    return bytes;
+}
+
+std::bitset<256> wordSet() {
+    std::bitset<256> bytes = rangeSet('a', 'z') | rangeSet('A', 'Z') | rangeSet('0', '9');
+    bytes.set('_');
+    return bytes;
+}
+
+std::bitset<256> spaceSet() {
+    std::bitset<256> bytes;
+    for (char c : std::string(" \t\n\r\f\v")) bytes.set(static_cast<unsigned char>(c));
+    return bytes;
+}
+
+/**
+ * @brief Add the other case of every ASCII letter in a set
+ */
+void foldSet(std::bitset<256>& bytes) {
+    for (int c = 'a'; c <= 'z'; ++c) {
+        if (bytes.test(c) || bytes.test(c ^ 0x20)) {
+            bytes.set(c);
+            bytes.set(c ^ 0x20);
+        }
+    }
+}
+
+/**
+ * @brief Bytes of a POSIX class such as "alpha", in the C locale
+ *
+ * @return false if the name is not a known class
+ */
+bool posixClass(const std::string& name, std::bitset<256>& bytes) {
+    int (*test)(int) = nullptr;
+    if (name == "alpha") test = isalpha;
+    else if (name == "digit") test = isdigit;
+    else if (name == "alnum") test = isalnum;
+    else if (name == "upper") test = isupper;
+    else if (name == "lower") test = islower;
+    else if (name == "space") test = isspace;
+    else if (name == "blank") test = isblank;
+    else if (name == "punct") test = ispunct;
+    else if (name == "print") test = isprint;
+    else if (name == "graph") test = isgraph;
+    else if (name == "cntrl") test = iscntrl;
+    else if (name == "xdigit") test = isxdigit;
+    else return false;
+    for (int c = 0; c < 128; ++c) {
+        if (test(c)) bytes.set(c);
+    }
+    return true;
+}
+
+/**
+ * @class Parser
+ *
+ * @brief Recursive-descent parser for one pattern
+ *
+ * @details Throws std::invalid_argument naming the problem and its offset.
+ * With foldCase the members of a bracket class are folded before a leading
+ * '^' negates it, so [^a-z] under -i excludes A-Z as well.
+ */
+class Parser {
+public:
+    Parser(const std::string& text, bool foldCase) : text(text), foldCase(foldCase) {}
+
+    std::unique_ptr<Node> parse() {
+        std::unique_ptr<Node> root = parseAlt();
+        if (pos < text.size()) {
+            fail("unmatched ')'");
+        }
+        return root;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::invalid_argument(what + " at offset " + std::to_string(pos) + " in '" + text + "'");
+    }
+
+    bool atEnd() const { return pos >= text.size(); }
+    char peek() const { return text[pos]; }
+
+    std::unique_ptr<Node> parseAlt() {
+        std::unique_ptr<Node> first = parseConcat();
+        if (atEnd() || peek() != '|') {
+            return first;
+        }
+        std::unique_ptr<Node> alt = makeNode(Node::kind::alt);
+        alt->kids.push_back(std::move(first));
+        while (!atEnd() && peek() == '|') {
+            ++pos;
+            alt->kids.push_back(parseConcat());
+        }
+        return alt;
+    }
+
+    std::unique_ptr<Node> parseConcat() {
+        std::unique_ptr<Node> concat = makeNode(Node::kind::concat);
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            std::unique_ptr<Node> item = parseRepeat();
+            // Splice unquantified groups so their literals join their neighbours'
+            if (item->type == Node::kind::concat) {
+                for (std::unique_ptr<Node>& kid : item->kids) concat->kids.push_back(std::move(kid));
+            } else {
+                concat->kids.push_back(std::move(item));
+            }
+        }
+        if (concat->kids.empty()) return makeNode(Node::kind::empty);
+        if (concat->kids.size() == 1) return std::move(concat->kids[0]);
+        return concat;
+    }
+
+    bool countFollows() const {
+        return pos + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[pos + 1]));
+    }
+
+    int parseNumber() {
+        long n = 0;
+        bool any = false;
+        while (!atEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            n = n * 10 + (peek() - '0');
+            if (n > MAX_REPEAT) fail("repetition count too large");
+            ++pos;
+            any = true;
+        }
+        if (!any) fail("bad repetition count");
+        return static_cast<int>(n);
+    }
+
+    std::unique_ptr<Node> parseRepeat() {
+        std::unique_ptr<Node> atom = parseAtom();
+        while (!atEnd()) {
+            int min = 0;
+            int max = 0;
+            char c = peek();
+            if (c == '*') {
+                min = 0; max = -1; ++pos;
+            } else if (c == '+') {
+                min = 1; max = -1; ++pos;
+            } else if (c == '?') {
+                min = 0; max = 1; ++pos;
+            } else if (c == '{' && countFollows()) {
+                ++pos;
+                min = parseNumber();
+                max = min;
+                if (!atEnd() && peek() == ',') {
+                    ++pos;
+                    max = (!atEnd() && peek() == '}') ? -1 : parseNumber();
+                }
+                if (atEnd() || peek() != '}') fail("missing '}'");
+                ++pos;
+                if (max != -1 && max < min) fail("bad repetition count");
+            } else {
+                break;
+            }
+            std::unique_ptr<Node> repeat = makeNode(Node::kind::repeat);
+            repeat->min = min;
+            repeat->max = max;
+            repeat->kids.push_back(std::move(atom));
+            atom = std::move(repeat);
+        }
+        return atom;
+    }
+
+    std::unique_ptr<Node> parseAtom() {
+        char c = peek();
+        switch (c) {
+            case '(': {
+                if (++depth > MAX_NESTING) fail("groups nested too deeply");
+                ++pos;
+                std::unique_ptr<Node> inner = parseAlt();
+                if (atEnd() || peek() != ')') fail("unmatched '('");
+                ++pos;
+                --depth;
+                return inner;
+            }
+            case '[':
+                ++pos;
+                return makeSet(parseClass());
+            case '.': {
+                ++pos;
+                std::bitset<256> any;
+                any.set();
+                any.reset('\n');
+                return makeSet(any);
+            }
+            case '^':
+                ++pos;
+                return makeNode(Node::kind::bol);
+            case '$':
+                ++pos;
+                return makeNode(Node::kind::eol);
+            case '\\':
+                ++pos;
+                return makeSet(parseEscape());
+            case '*':
+            case '+':
+            case '?':
+                fail("nothing to repeat");
+            case '{':
+                if (countFollows()) fail("nothing to repeat");
+                break;
+            default:
+                break;
+        }
+        ++pos;
+        std::bitset<256> one;
+        one.set(static_cast<unsigned char>(c));
+        return makeSet(one);
+    }
+
+    // Called just after a backslash, outside or inside a bracket class
+    std::bitset<256> parseEscape() {
+        if (atEnd()) fail("trailing backslash");
+        char c = text[pos++];
+        std::bitset<256> bytes;
+        switch (c) {
+            case 'd': return rangeSet('0', '9');
+            case 'D': return ~rangeSet('0', '9');
+            case 'w': return wordSet();
+            case 'W': return ~wordSet();
+            case 's': return spaceSet();
+            case 'S': return ~spaceSet();
+            case 't': bytes.set('\t'); return bytes;
+            case 'n': bytes.set('\n'); return bytes;
+            default:
+                if (std::isalnum(static_cast<unsigned char>(c))) {
+                    --pos;
+                    fail(std::string("unsupported escape \\") + c);
+                }
+                bytes.set(static_cast<unsigned char>(c));
+                return bytes;
+        }
+    }
+
+    // Called just after '['; consumes through the closing ']'
+    std::bitset<256> parseClass() {
+        std::bitset<256> bytes;
+        bool negate = false;
+        if (!atEnd() && peek() == '^') {
+            negate = true;
+            ++pos;
+        }
+        bool first = true;
+        while (true) {
+            if (atEnd()) fail("missing ']'");
+            char c = peek();
+            if (c == ']' && !first) {
+                ++pos;
+                break;
+            }
+            first = false;
+
+            if (c == '[' && pos + 1 < text.size() && text[pos + 1] == ':') {
+                std::size_t close = text.find(":]", pos + 2);
+                if (close == std::string::npos) fail("missing ':]'");
+                if (!posixClass(text.substr(pos + 2, close - pos - 2), bytes)) fail("unknown character class");
+                pos = close + 2;
+                continue;
+            }
+
+            int low;
+            if (c == '\\') {
+                ++pos;
+                std::bitset<256> escaped = parseEscape();
+                if (escaped.count() != 1) {
+                    bytes |= escaped;
+                    continue;
+                }
+                low = static_cast<int>(escaped._Find_first());
+            } else {
+                low = static_cast<unsigned char>(c);
+                ++pos;
+            }
+
+            // A '-' between two bytes is a range; first or last it is literal
+            if (pos + 1 < text.size() && peek() == '-' && text[pos + 1] != ']') {
+                ++pos;
+                int high;
+                if (peek() == '\\') {
+                    ++pos;
+                    std::bitset<256> escaped = parseEscape();
+                    if (escaped.count() != 1) fail("bad range in character class");
+                    high = static_cast<int>(escaped._Find_first());
+                } else {
+                    high = static_cast<unsigned char>(peek());
+                    ++pos;
+                }
+                if (high < low) fail("bad range in character class");
+                bytes |= rangeSet(low, high);
+            } else {
+                bytes.set(low);
+            }
+        }
+        if (foldCase) {
+            foldSet(bytes);
+        }
+        if (negate) {
+            bytes.flip();
+            bytes.reset('\n');
+        }
+        return bytes;
+    }
+
+    const std::string& text;
+    const bool foldCase;
+    std::size_t pos = 0;
+    int depth = 0;
+};
+
+std::string longer(std::string a, std::string b) {
+    return b.size() > a.size() ? b : a;
+}
+
+/**
+ * @brief Longest literal that every match of a node must contain
+ *
+ * @details Runs of single-byte sets in a concatenation are literals; the
+ * kid of a repeat that must occur at least once passes its literal up.
+ * Alternations and optional parts contribute nothing.
+ */
+std::string requiredLiteral(const Node& node) {
+    auto single = [](const Node& n) {
+        return n.type == Node::kind::set && n.bytes.count() == 1 && !n.bytes.test('\n');
+    };
+    switch (node.type) {
+        case Node::kind::set:
+            return single(node) ? std::string(1, static_cast<char>(node.bytes._Find_first())) : std::string();
+        case Node::kind::repeat:
+            return node.min >= 1 ? requiredLiteral(*node.kids[0]) : std::string();
+        case Node::kind::concat: {
+            std::string best;
+            std::string run;
+            for (const std::unique_ptr<Node>& kid : node.kids) {
+                if (single(*kid)) {
+                    run += static_cast<char>(kid->bytes._Find_first());
+                    continue;
+                }
+                best = longer(std::move(best), std::move(run));
+                run.clear();
+                best = longer(std::move(best), requiredLiteral(*kid));
+            }
+            return longer(std::move(best), std::move(run));
+        }
+        default:
+            return std::string();
+    }
+}
+
+enum class nfaKind : std::uint8_t { range, split, match, bol, eol, epsilon };
+
+} // namespace
+
+/**
+ * @struct RegexMatcher::NfaState
+ *
+ * @brief One NFA state
+ *
+ * @details A range state consumes one byte of sets[set] and moves to out. A
+ * split moves to both out and out1 without consuming anything; epsilon, bol
+ * and eol move to out, the anchors only at a line start or end. A match
+ * state ends pattern number pattern.
+ */
+struct RegexMatcher::NfaState {
+    nfaKind kind;
+    int out = -1;
+    int out1 = -1;
+    int set = -1;
+    int pattern = -1;
+};
+
+/**
+ * @struct RegexMatcher::Compiler
+ *
+ * @brief Thompson construction from syntax tree to NFA
+ *
+ * @details Each node compiles to a fragment: its start state and the list of
+ * dangling exits that the next fragment is patched onto.
+ */
+struct RegexMatcher::Compiler {
+    struct Frag {
+        int start;
+        std::vector<std::pair<int, bool>> outs; // state, and whether the exit is out1
+    };
+
+    std::vector<NfaState>& nfa;
+    std::vector<std::bitset<256>>& sets;
+    bool foldCase;
+    std::unordered_map<std::bitset<256>, int> setIndex;
+
+    int add(nfaKind kind) {
+        if (nfa.size() >= MAX_NFA_STATES) {
+            throw std::invalid_argument("regular expression is too large");
+        }
+        NfaState state;
+        state.kind = kind;
+        nfa.push_back(state);
+        return static_cast<int>(nfa.size() - 1);
+    }
+
+    void patch(const std::vector<std::pair<int, bool>>& outs, int target) {
+        for (const auto& exit : outs) {
+            if (exit.second) nfa[exit.first].out1 = target;
+            else nfa[exit.first].out = target;
+        }
+    }
+
+    Frag single(nfaKind kind) {
+        int s = add(kind);
+        return Frag{s, {{s, false}}};
+    }
+
+    // Append next to frag (frag may be empty: start == -1)
+    void chain(Frag& frag, Frag next) {
+        if (frag.start < 0) {
+            frag = std::move(next);
+            return;
+        }
+        patch(frag.outs, next.start);
+        frag.outs = std::move(next.outs);
+    }
+
+    // A split whose first branch is body and whose second is left dangling
+    Frag optional(const Node& body, bool loop) {
+        int s = add(nfaKind::split);
+        Frag inner = compile(body);
+        nfa[s].out = inner.start;
+        Frag frag{s, {{s, true}}};
+        if (loop) {
+            patch(inner.outs, s);
+        } else {
+            frag.outs.insert(frag.outs.end(), inner.outs.begin(), inner.outs.end());
+        }
+        return frag;
+    }
+
+    Frag compile(const Node& node) {
+        switch (node.type) {
+            case Node::kind::set: {
+                Frag frag = single(nfaKind::range);
+                std::bitset<256> bytes = node.bytes;
+                if (foldCase) {
+                    foldSet(bytes);
+                }
+                auto found = setIndex.find(bytes);
+                if (found == setIndex.end()) {
+                    found = setIndex.emplace(bytes, static_cast<int>(sets.size())).first;
+                    sets.push_back(bytes);
+                }
+                nfa[frag.start].set = found->second;
+                return frag;
+            }
+            case Node::kind::bol:
+                return single(nfaKind::bol);
+            case Node::kind::eol:
+                return single(nfaKind::eol);
+            case Node::kind::empty:
+                return single(nfaKind::epsilon);
+            case Node::kind::concat: {
+                Frag frag{-1, {}};
+                for (const std::unique_ptr<Node>& kid : node.kids) {
+                    chain(frag, compile(*kid));
+                }
+                return frag;
+            }
+            case Node::kind::alt: {
+                // A chain of splits, one branch per alternative
+                Frag frag{-1, {}};
+                int prevSplit = -1;
+                for (std::size_t i = 0; i < node.kids.size(); ++i) {
+                    int entry;
+                    Frag branch = compile(*node.kids[i]);
+                    if (i + 1 < node.kids.size()) {
+                        entry = add(nfaKind::split);
+                        nfa[entry].out = branch.start;
+                    } else {
+                        entry = branch.start;
+                    }
+                    if (prevSplit < 0) frag.start = entry;
+                    else nfa[prevSplit].out1 = entry;
+                    prevSplit = entry;
+                    frag.outs.insert(frag.outs.end(), branch.outs.begin(), branch.outs.end());
+                }
+                return frag;
+            }
+            case Node::kind::repeat: {
+                const Node& body = *node.kids[0];
+                Frag frag{-1, {}};
+                for (int i = 0; i < node.min; ++i) {
+                    chain(frag, compile(body));
+                }
+                if (node.max < 0) {
+                    chain(frag, optional(body, /*loop*/ true));
+                } else {
+                    for (int i = node.min; i < node.max; ++i) {
+                        chain(frag, optional(body, /*loop*/ false));
+                    }
+                }
+                if (frag.start < 0) {
+                    return single(nfaKind::epsilon);
+                }
+                return frag;
+            }
+        }
+        return single(nfaKind::epsilon);
+    }
+};
+
+/**
+ * @struct RegexMatcher::DfaCache
+ *
+ * @brief One thread's lazily built DFA for one matcher
+ *
+ * @details State i is the NFA state set members[i]; match[i] is the pattern
+ * that has matched on reaching it (or -1), eolMatch[i] the pattern that
+ * matches if the line ends there (computed on first use; emptyLineMatch is
+ * the same for the line-start state on an empty line), and row i of next
+ * holds its transitions per byte class, -1 until taken. A state with no NFA
+ * states left is DEAD: nothing more can match on its line. The closure walk
+ * marks visited NFA states with the current generation so the marks never
+ * have to be cleared.
+ */
+struct RegexMatcher::DfaCache {
+    static constexpr int NO_MATCH = -1;
+    static constexpr int UNKNOWN = -2;
+    static constexpr int DEAD = -3;
+
+    std::uint64_t owner = 0;
+    std::vector<std::vector<int>> members;
+    std::vector<int> match;
+    std::vector<int> eolMatch;
+    std::vector<int> next;
+    std::unordered_map<std::string, int> index;
+    std::size_t bytes = 0;
+    int lineStart = -1;
+    int emptyLineMatch = UNKNOWN;
+    std::uint64_t flushes = 0;
+
+    std::vector<std::uint32_t> mark;
+    std::uint32_t generation = 0;
+    std::vector<int> stack;
+    std::vector<int> scratch;
+
+    void clear() {
+        members.clear();
+        match.clear();
+        eolMatch.clear();
+        next.clear();
+        index.clear();
+        bytes = 0;
+        lineStart = -1;
+        emptyLineMatch = UNKNOWN;
+    }
+
+    void newGeneration() {
+        if (++generation == 0) {
+            std::fill(mark.begin(), mark.end(), 0);
+            generation = 1;
+        }
+    }
+};
+
+static std::atomic<std::uint64_t> nextMatcherId{1};
+
+RegexMatcher::RegexMatcher(const std::vector<std::string>& patterns, bool foldCase, std::size_t cacheBytes)
+    : cacheBytes(cacheBytes), id(nextMatcherId++) {
+    Compiler compiler{nfa, sets, foldCase, {}};
+    bool allHaveLiterals = !patterns.empty();
+    std::vector<int> starts;
+    for (std::size_t i = 0; i < patterns.size(); ++i) {
+        std::unique_ptr<Node> root = Parser(patterns[i], foldCase).parse();
+
+        std::string literal = requiredLiteral(*root);
+        if (literal.size() < MIN_PREFILTER_LENGTH) allHaveLiterals = false;
+        literals.push_back(std::move(literal));
+
+        Compiler::Frag frag = compiler.compile(*root);
+        int accept = compiler.add(nfaKind::match);
+        nfa[accept].pattern = static_cast<int>(i);
+        compiler.patch(frag.outs, accept);
+        starts.push_back(frag.start);
+    }
+
+    // One split chain leads into every pattern
+    start = starts.empty() ? compiler.add(nfaKind::epsilon) : starts.back();
+    for (std::size_t i = starts.size(); i-- > 1;) {
+        int s = compiler.add(nfaKind::split);
+        nfa[s].out = starts[i - 1];
+        nfa[s].out1 = start;
+        start = s;
+    }
+
+    if (allHaveLiterals) {
+        Matcher* literalMatcher;
+        if (literals.size() > 1) {
+            literalMatcher = new AhoCorasickMatcher(literals, foldCase);
+        } else if (foldCase) {
+            literalMatcher = new BasicLiteralMatcher<true, false>(literals[0]);
+        } else {
+            literalMatcher = new LiteralMatcher(literals[0]);
+        }
+        prefilter.reset(literalMatcher);
+    } else {
+        literals.clear();
+    }
+
+    // Refine the byte classes by every set, and give the newline its own
+    std::memset(byteClass, 0, sizeof(byteClass));
+    classes = 1;
+    std::vector<std::bitset<256>> splitters = sets;
+    splitters.emplace_back().set('\n');
+    for (const std::bitset<256>& set : splitters) {
+        std::vector<int> inside(classes, -1);
+        std::vector<int> outside(classes, -1);
+        std::size_t refined = 0;
+        for (int c = 0; c < 256; ++c) {
+            int& target = set.test(c) ? inside[byteClass[c]] : outside[byteClass[c]];
+            if (target < 0) target = static_cast<int>(refined++);
+            byteClass[c] = static_cast<std::uint16_t>(target);
+        }
+        classes = refined;
+    }
+    classByte.assign(classes, 0);
+    for (int c = 255; c >= 0; --c) {
+        classByte[byteClass[c]] = static_cast<unsigned char>(c);
+    }
+}
+
+RegexMatcher::~RegexMatcher() {}
+
+RegexMatcher::DfaCache& RegexMatcher::threadCache() const {
+    static thread_local DfaCache cache;
+    if (cache.owner != id) {
+        cache.clear();
+        cache.owner = id;
+        cache.mark.assign(nfa.size(), 0);
+        cache.generation = 0;
+    }
+    return cache;
+}
+
+/**
+ * @brief Add the states reachable from state without consuming a byte
+ *
+ * @details Only range, match and (while the line has not ended) eol states
+ * are kept; they are all a DFA state needs. The caller starts a generation.
+ */
+void RegexMatcher::addClosure(DfaCache& cache, int state, bool bol, bool eol, std::vector<int>& out) const {
+    std::vector<int>& stack = cache.stack;
+    stack.push_back(state);
+    while (!stack.empty()) {
+        int s = stack.back();
+        stack.pop_back();
+        if (s < 0 || cache.mark[s] == cache.generation) continue;
+        cache.mark[s] = cache.generation;
+        const NfaState& n = nfa[s];
+        switch (n.kind) {
+            case nfaKind::range:
+            case nfaKind::match:
+                out.push_back(s);
+                break;
+            case nfaKind::split:
+                stack.push_back(n.out1);
+                stack.push_back(n.out);
+                break;
+            case nfaKind::epsilon:
+                stack.push_back(n.out);
+                break;
+            case nfaKind::bol:
+                if (bol) stack.push_back(n.out);
+                break;
+            case nfaKind::eol:
+                if (eol) stack.push_back(n.out);
+                else out.push_back(s);
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Find or create the DFA state for a set of NFA states
+ *
+ * @details If the new state would push the cache past its budget, the cache
+ * is cleared first; state numbers the caller held are then invalid.
+ */
+int RegexMatcher::intern(DfaCache& cache, std::vector<int>& states) const {
+    std::sort(states.begin(), states.end());
+    std::string key(reinterpret_cast<const char*>(states.data()), states.size() * sizeof(int));
+    auto found = cache.index.find(key);
+    if (found != cache.index.end()) {
+        return found->second;
+    }
+
+    std::size_t cost = classes * sizeof(int) + 2 * key.size() + 96;
+    if (cache.bytes + cost > cacheBytes && !cache.members.empty()) {
+        cache.clear();
+        ++cache.flushes;
+    }
+    cache.bytes += cost;
+
+    // With no NFA states left, the rest of the line cannot match
+    int matched = states.empty() ? DfaCache::DEAD : DfaCache::NO_MATCH;
+    for (int s : states) {
+        if (nfa[s].kind == nfaKind::match && (matched < 0 || nfa[s].pattern < matched)) {
+            matched = nfa[s].pattern;
+        }
+    }
+    int added = static_cast<int>(cache.members.size());
+    cache.members.push_back(states);
+    cache.match.push_back(matched);
+    cache.eolMatch.push_back(DfaCache::UNKNOWN);
+    cache.next.resize(cache.next.size() + classes, -1);
+    cache.index.emplace(std::move(key), added);
+    return added;
+}
+
+int RegexMatcher::lineStartState(DfaCache& cache) const {
+    if (cache.lineStart < 0) {
+        std::vector<int>& out = cache.scratch;
+        out.clear();
+        cache.newGeneration();
+        addClosure(cache, start, /*bol*/ true, /*eol*/ false, out);
+        cache.lineStart = intern(cache, out);
+    }
+    return cache.lineStart;
+}
+
+int RegexMatcher::step(DfaCache& cache, int state, std::uint16_t cls) const {
+    unsigned char byte = classByte[cls];
+    std::vector<int>& out = cache.scratch;
+    out.clear();
+    cache.newGeneration();
+    for (int s : cache.members[state]) {
+        const NfaState& n = nfa[s];
+        if (n.kind == nfaKind::range && sets[n.set].test(byte)) {
+            addClosure(cache, n.out, false, false, out);
+        }
+    }
+    // Unanchored: a match may also begin at the next byte
+    addClosure(cache, start, false, false, out);
+
+    std::uint64_t flushes = cache.flushes;
+    int target = intern(cache, out);
+    if (cache.flushes == flushes) {
+        cache.next[static_cast<std::size_t>(state) * classes + cls] = target;
+    }
+    return target;
+}
+
+int RegexMatcher::eolMatch(DfaCache& cache, int state, bool emptyLine) const {
+    // On an empty line "^" still holds at the end, so it gets its own slot
+    int& known = emptyLine ? cache.emptyLineMatch : cache.eolMatch[state];
+    if (known != DfaCache::UNKNOWN) {
+        return known;
+    }
+    int matched = cache.match[state];
+    std::vector<int>& out = cache.scratch;
+    out.clear();
+    cache.newGeneration();
+    for (int s : cache.members[state]) {
+        if (nfa[s].kind == nfaKind::eol) {
+            addClosure(cache, nfa[s].out, emptyLine, true, out);
+        }
+    }
+    for (int s : out) {
+        if (nfa[s].kind == nfaKind::match && (matched < 0 || nfa[s].pattern < matched)) {
+            matched = nfa[s].pattern;
+        }
+    }
+    known = matched;
+    return matched;
+}
+
+/**
+ * @brief Run the DFA over whole lines
+ *
+ * @param begin Start of a line
+ * @param end End of the range; a line running into it ends there
+ *
+ * @return A pointer into the first matching line, or nullptr
+ */
+const char* RegexMatcher::scanLines(const char* begin, const char* end, std::size_t& pattern) const {
+    DfaCache& cache = threadCache();
+    const std::uint16_t* cls = byteClass;
+    const char* p = begin;
+    while (p < end) {
+        const char* lineStart = p;
+        int s = lineStartState(cache);
+        const int* next = cache.next.data();
+        const int* match = cache.match.data();
+        while (match[s] == DfaCache::NO_MATCH && p < end && *p != '\n') {
+            std::uint16_t c = cls[static_cast<unsigned char>(*p)];
+            int t = next[static_cast<std::size_t>(s) * classes + c];
+            if (t < 0) {
+                t = step(cache, s, c);
+                next = cache.next.data();
+                match = cache.match.data();
+            }
+            s = t;
+            ++p;
+        }
+        if (match[s] == DfaCache::DEAD) {
+            // Nothing can match on the rest of this line
+            const void* nl = std::memchr(p, '\n', end - p);
+            p = nl ? static_cast<const char*>(nl) + 1 : end;
+            continue;
+        }
+        int matched = match[s] >= 0 ? match[s] : eolMatch(cache, s, p == lineStart);
+        if (matched >= 0) {
+            pattern = static_cast<std::size_t>(matched);
+            return p > lineStart ? p - 1 : p;
+        }
+        ++p; // past the newline
+    }
+    return nullptr;
+}
+
+const char* RegexMatcher::find(const char* begin, const char* end) const {
+    std::size_t pattern;
+    return findPattern(begin, end, pattern);
+}
+
+const char* RegexMatcher::findPattern(const char* begin, const char* end, std::size_t& pattern) const {
+    if (!prefilter) {
+        return scanLines(begin, end, pattern);
+    }
+    // Only lines holding a required literal can match
+    const char* p = begin;
+    while (p < end) {
+        const char* hit = prefilter->find(p, end);
+        if (!hit) {
+            return nullptr;
+        }
+        const char* lineStart = p;
+        if (hit > p) {
+            const void* nl = memrchr(p, '\n', hit - p);
+            if (nl) lineStart = static_cast<const char*>(nl) + 1;
+        }
+        const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', end - hit));
+        if (!lineEnd) lineEnd = end;
+        if (const char* found = scanLines(lineStart, lineEnd, pattern)) {
+            return found;
+        }
+        p = lineEnd + 1;
+    }
+    return nullptr;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file src/regex_matcher.h
+ *
+ * @brief Declaration of the regular-expression matcher built on a lazy DFA.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of RegexMatcher. Patterns are parsed
+ * into a syntax tree and compiled into a Thompson NFA. Searching runs a DFA
+ * whose states (sets of NFA states) are only built the first time the scan
+ * needs them and are kept in a cache of bounded size. Every match must lie
+ * within one line, like grep: "." and negated classes never match a newline.
+ *
+ * Supported syntax (POSIX ERE style): literals, ".", bracket classes with
+ * ranges and negation, the escapes \d \D \w \W \s \S \t \n and escaped
+ * metacharacters, "^" and "$" (line anchors), grouping with "( )",
+ * alternation with "|", and the quantifiers "*", "+", "?", "{m}", "{m,}"
+ * and "{m,n}".
+ *
+ * Before the automaton runs, a literal that every match must contain is
+ * extracted from each pattern. When every pattern has one, those literals
+ * are searched for with the literal (or Aho-Corasick) matcher first and the
+ * DFA only runs on the lines that contain one.
+ */
+
+#ifndef REGEX_MATCHER_H
+#define REGEX_MATCHER_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "matcher.h"
+
+/**
+ * @class RegexMatcher
+ *
+ * @brief Matcher for one or more regular expressions
+ *
+ * @details The constructor throws std::invalid_argument with a description
+ * of the problem if a pattern cannot be parsed. find() returns a pointer into
+ * the first line that matches (the last byte of the match, or the line start
+ * for an empty match); findPattern() also reports the lowest-numbered pattern
+ * that matched there. Each thread keeps its own DFA cache, so a RegexMatcher
+ * can be shared between threads without locking. When a thread's cache grows
+ * past cacheBytes it is cleared and rebuilt on demand. With foldCase every
+ * ASCII letter in a pattern matches both cases.
+ */
+class RegexMatcher final : public Matcher {
+public:
+    // Default memory budget for one thread's DFA cache
+    static constexpr std::size_t DEFAULT_CACHE_BYTES = std::size_t(2) << 20;
+
+    explicit RegexMatcher(const std::vector<std::string>& patterns,
+                          bool foldCase = false,
+                          std::size_t cacheBytes = DEFAULT_CACHE_BYTES);
+    ~RegexMatcher();
+
+    const char* find(const char* begin, const char* end) const override;
+    const char* findPattern(const char* begin, const char* end, std::size_t& pattern) const override;
+
+    // The literals the prefilter searches for (empty when there is no prefilter)
+    const std::vector<std::string>& requiredLiterals() const { return literals; }
+
+private:
+    struct NfaState;
+    struct Compiler;
+    struct DfaCache;
+
+    DfaCache& threadCache() const;
+    void addClosure(DfaCache& cache, int state, bool bol, bool eol, std::vector<int>& out) const;
+    int intern(DfaCache& cache, std::vector<int>& states) const;
+    int lineStartState(DfaCache& cache) const;
+    int step(DfaCache& cache, int state, std::uint16_t cls) const;
+    int eolMatch(DfaCache& cache, int state, bool emptyLine) const;
+    const char* scanLines(const char* begin, const char* end, std::size_t& pattern) const;
+
+    std::vector<NfaState> nfa;
+    std::vector<std::bitset<256>> sets;   // byte sets of the range states
+    int start = -1;
+    std::uint16_t byteClass[256];
+    std::size_t classes = 0;
+    std::vector<unsigned char> classByte; // one byte of each class
+    std::size_t cacheBytes;
+    std::uint64_t id;                     // tells thread caches of different matchers apart
+
+    std::vector<std::string> literals;
+    std::unique_ptr<Matcher> prefilter;
+};
+
+#endif // REGEX_MATCHER_H
@@ -0,0 +1,69 @@
+/**
+ * @file src/reorder.cpp
+ *
+ * @brief Implementation of the reorder window and buffer.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ */
+
+#include "reorder.h"
+
+bool ReorderWindow::open(std::uint64_t sequence) const {
+    // The printer's next file is always admitted, or nothing could move
+    return sequence == printed || (!held && sequence < printed + size);
+}
+
+/**
+ * @brief Whether the producer may send this file now without waiting
+ */
+bool ReorderWindow::admits(std::uint64_t sequence) {
+    std::lock_guard<std::mutex> lk(mut);
+    return open(sequence);
+}
+
+/**
+ * @brief Block the producer until the printer has caught up enough for this file
+ */
+void ReorderWindow::waitFor(std::uint64_t sequence) {
+    std::unique_lock<std::mutex> lk(mut);
+    moved.wait(lk, [&] { return open(sequence); });
+}
+
+/**
+ * @brief Called by the printer with the next file it needs and whether it holds too much
+ */
+void ReorderWindow::advance(std::uint64_t next, bool full) {
+    {
+        std::lock_guard<std::mutex> lk(mut);
+        if (next == printed && full == held) return;
+        printed = next;
+        held = full;
+    }
+    moved.notify_all();
+}
+
+std::size_t ReorderBuffer::footprint(const MatchSlab& slab) {
+    return sizeof(MatchSlab) + slab.text.capacity() + slab.matches.capacity() * sizeof(Match);
+}
+
+void ReorderBuffer::put(MatchSlab* slab, std::vector<MatchSlab*>& ready) {
+    if (slab->sequence == NO_SEQUENCE) {
+        ready.push_back(slab);
+        return;
+    }
+    if (slab->sequence != nextSequence) {
+        slots[slab->sequence % slots.size()] = slab;
+        bytes += footprint(*slab);
+        return;
+    }
+    ready.push_back(slab);
+    ++nextSequence;
+    // Everything that arrived early and is now in sequence follows it
+    while (MatchSlab* held = slots[nextSequence % slots.size()]) {
+        slots[nextSequence % slots.size()] = nullptr;
+        bytes -= footprint(*held);
+        ready.push_back(held);
+        ++nextSequence;
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file src/reorder.h
+ *
+ * @brief Declaration of the window and buffer that put results back in traversal order.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declarations of ReorderWindow and ReorderBuffer,
+ * which implement --sort. The producer numbers every file it sends in
+ * traversal order, the workers search in parallel as usual and report every
+ * numbered file exactly once (an empty slab if it has no matches), and the
+ * printer holds slabs that arrive early in a ReorderBuffer until all earlier
+ * files have been printed. The ReorderWindow keeps the producer at most
+ * REORDER_WINDOW files ahead of the printer, and stops it altogether while
+ * the held slabs take more than REORDER_MAX_BYTES, so the memory held for
+ * reordering stays bounded however slow one file is.
+ */
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "match.h"
+
+// Files the producer may run ahead of the printer with --sort
+constexpr std::size_t REORDER_WINDOW = 1024;
+
+// The producer waits while the printer holds more than this many bytes of early results
+constexpr std::size_t REORDER_MAX_BYTES = std::size_t(64) << 20;
+
+/**
+ * @class ReorderWindow
+ *
+ * @brief Flow control between the producer and the printer for ordered output
+ *
+ * @details Every file the producer numbers is eventually reported, so the
+ * printer can always make progress on the files already admitted; holding
+ * back new ones therefore never deadlocks, provided the producer sends the
+ * tasks it has batched before it waits (see admits()).
+ */
+class ReorderWindow {
+public:
+    explicit ReorderWindow(std::size_t files = REORDER_WINDOW) : size(files) {}
+
+    bool admits(std::uint64_t sequence);
+    void waitFor(std::uint64_t sequence);
+    void advance(std::uint64_t next, bool full);
+
+private:
+    bool open(std::uint64_t sequence) const;
+
+    const std::size_t size;
+    std::mutex mut;
+    std::condition_variable moved;
+    std::uint64_t printed = 0;
+    bool held = false;
+};
+
+/**
+ * @class ReorderBuffer
+ *
+ * @brief The printer's slabs that arrived before their turn
+ *
+ * @details Slabs are kept in a ring indexed by sequence number modulo the
+ * window size, which the ReorderWindow guarantees is enough. put() hands
+ * back, in order, every slab that became printable; slabs without a
+ * sequence number (replayed from the manifest) are handed back at once.
+ */
+class ReorderBuffer {
+public:
+    explicit ReorderBuffer(std::size_t files = REORDER_WINDOW) : slots(files, nullptr) {}
+
+    void put(MatchSlab* slab, std::vector<MatchSlab*>& ready);
+
+    std::uint64_t next() const { return nextSequence; }
+    std::size_t heldBytes() const { return bytes; }
+
+private:
+    static std::size_t footprint(const MatchSlab& slab);
+
+    std::vector<MatchSlab*> slots;
+    std::uint64_t nextSequence = 0;
+    std::size_t bytes = 0;
+};
+
+#endif // REORDER_H
@@ -12,18 +12,179 @@
  * parses command-line arguments to determine the target string and root
  * directory for the search. It sets up channels for file paths and search
  * results, starts the producer thread, a pool of worker threads, and a
- * printer thread. It waits for all threads to complete before cleaning up
- * and exiting.
+ * printer thread. With --fused the producer, file channel and workers are
+ * replaced by one work-stealing pool that walks and searches. When a trigram
+ * index exists for the directory it is used to skip files that cannot match;
+ * the "index" subcommand builds it. It waits for all threads to complete
+ * before cleaning up and exiting.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <thread>
 #include <vector>
 #include <filesystem>
+#include <memory>
+#include <stdexcept>
 #include "channel.h"
+#include "fused_search.h"
+#include "matcher.h"
+#include "options.h"
+#include "regex_matcher.h"
 #include "producer.h"
+#include "read_ahead.h"
+#include "file_filter.h"
+#include "manifest.h"
+#include "trigram_index.h"
+#include "search_stats.h"
 #include "search_worker.h"
+#include "thread_pool.h"
+#include "walk_rules.h"
+#include "walker.h"
+
+/**
+ * @brief Run the producer -> file channel -> worker pool pipeline
+ * 
+ * @param options The parsed command-line options
+ * @param matcher The matcher for the target string
+ * @param limits When to stop searching a file and what to report
+ * @param resultChan The channel workers send match slabs through
+ * @param topology The CPUs and NUMA nodes to place the workers on
+ * @param poolSettings Worker count, pinning, grouping and resizing
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Rules out files that need not be searched, or nullptr
+ * @param order With --sort, numbers the files and paces the producer; nullptr otherwise
+ * 
+ * @return void
+ * 
+ * @details This function creates the file channel, starts the producer thread
+ * (or the parallel walker) and the worker pool, and returns once all of them
+ * have been joined. With --io-depth a read-ahead stage sits between the file
+ * channel and the workers, which then receive files already read. With
+ * --numa each worker group gets its own channel, filled from the shared one
+ * by fanOut. The result channel is left open for the caller to close.
+ */
+static void runPipeline(
+    const SearchOptions& options,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan,
+    const CpuTopology& topology,
+    const PoolSettings& poolSettings,
+    const WalkRules& rules,
+    const FileFilter* filter,
+    ReorderWindow* order
+) {
+    const std::filesystem::path& rootDir = options.root_dir;
+    channel<FileTask>* fileChan = makeChannel<FileTask>(/*buffer size*/ 64, options.channel_kind);
+
+    // Start producer thread (or the parallel walker, which runs its own threads);
+    // sorted output needs the one traversal order of the single producer
+    std::thread producerThread;
+    if (options.walker_threads > 1 && !order) {
+        producerThread = std::thread(
+            parallelWalkerFunc,
+            rootDir,
+            fileChan,
+            options.walker_threads,
+            std::cref(rules),
+            filter
+        );
+    } else {
+        producerThread = std::thread(
+            producerThreadFunc,
+            rootDir,
+            fileChan,
+            std::cref(rules),
+            filter,
+            order
+        );
+    }
+
+    // Start the read-ahead stage, if any; the workers then take files from it
+    channel<FileTask>* workChan = fileChan;
+    channel<FileTask>* loadedChan = nullptr;
+    std::thread readAheadThread;
+    if (options.io_depth > 0) {
+        loadedChan = makeChannel<FileTask>(options.io_depth, options.channel_kind);
+        readAheadThread = std::thread(
+            readAheadFunc,
+            fileChan,
+            loadedChan,
+            options.io_depth,
+            options.io_uring
+        );
+        workChan = loadedChan;
+    }
+
+    // Start the worker pool; with several groups each reads its own channel
+    ThreadPool pool(topology, poolSettings);
+    std::vector<channel<FileTask>*> groupChans;
+    std::thread fanOutThread;
+    if (pool.groupCount() > 1) {
+        // Each group's channel is built on its own node, so a lock-free ring lives where its workers read it
+        for (unsigned int i = 0; i < pool.groupCount(); ++i) {
+            pool.runOnGroup(i, [&] {
+                groupChans.push_back(makeChannel<FileTask>(/*buffer size*/ 64, options.channel_kind));
+            });
+        }
+        fanOutThread = std::thread(fanOut<FileTask>, workChan, groupChans);
+    }
+    pool.start([&](PoolWorker& worker) {
+        channel<FileTask>* in = groupChans.empty() ? workChan : groupChans[worker.group()];
+        workerThreadFunc(in, resultChan, matcher, limits, &worker);
+    });
+
+    // Join worker threads first: an adaptive pool resizes itself until they are done
+    pool.join();
+
+    // JOin producer thread
+    producerThread.join();
+    if (readAheadThread.joinable()) {
+        readAheadThread.join();
+    }
+    if (fanOutThread.joinable()) {
+        fanOutThread.join();
+    }
+
+    if (SearchStats* stats = SearchStats::enabled()) {
+        stats->addChannel("File", fileChan->stats());
+        if (loadedChan) stats->addChannel("Loaded", loadedChan->stats());
+    }
+    for (channel<FileTask>* groupChan : groupChans) {
+        delete groupChan;
+    }
+    delete loadedChan;
+    delete fileChan;
+}
+
+/**
+ * @brief Identify everything about a query that affects which lines match
+ * 
+ * @param options The parsed command-line options
+ * 
+ * @return std::string A key that differs whenever the matches could differ
+ * 
+ * @details A manifest is only reused by a run with the same key.
+ */
+static std::string queryKey(const SearchOptions& options) {
+    std::string key = options.syntax == patternSyntax::regex ? "regex" : "literal";
+    const MatchOptions& mode = options.match_options;
+    key += mode.ignore_case ? 'i' : '-';
+    key += mode.whole_word ? 'w' : '-';
+    key += mode.invert ? 'v' : '-';
+    // Summaries and capped line lists are recorded as printed, so they need their own key
+    key += options.report_mode == reportMode::files ? 'l' : options.report_mode == reportMode::counts ? 'c' : '-';
+    key += std::to_string(options.max_count);
+    key += options.search_binary ? 'a' : '-';
+    key += std::to_string(options.max_file_size);
+    for (const std::string& pattern : options.patterns) {
+        key += '\0';
+        key += pattern;
+    }
+    return key;
+}
 
 /**
  * @brief Main function to set up and run the multi-threaded search application
@@ -34,66 +195,164 @@
  * @return int Exit status
  * 
  * @details This function parses command-line arguments to determine the target
- * string and root directory for the search. It sets up channels for file paths
- * and search results, starts the producer thread, a pool of worker threads, and
- * a printer thread. It waits for all threads to complete before cleaning up
- * and exiting.
+ * string and root directory for the search. For the "index" subcommand it builds
+ * the trigram index and exits. Otherwise it opens the index if there is one and
+ * loads the manifest if --manifest was given, sets up the result channel and
+ * printer thread, then runs either the channel pipeline (producer thread and a
+ * pool of worker threads) or, with --fused, the fused walk-and-search pool.
+ * Matches cached in the manifest for unchanged files are replayed afterwards.
+ * It waits for all threads to complete before cleaning up and exiting.
  */
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: bin/search <target> [directory]" << std::endl;
+    SearchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
         return 1;
     }
 
-    std::string target = argv[1];
-    std::filesystem::path rootDir = (argc >= 3) ? argv[2] : std::filesystem::current_path();
+    // Sorted output is numbered by the single producer, which --fused does without
+    if (options.sort_output) {
+        options.fused = false;
+    }
+
+    const std::vector<std::string>& patterns = options.patterns;
+    const std::filesystem::path& rootDir = options.root_dir;
 
     // Determine number of threads in pool 
-    unsigned int hw = std::thread::hardware_concurrency();
-    if (hw < 2) hw = 2; // Minimum 2 threads based on assignment
+    unsigned int hw = options.threads;
+    if (hw == 0) {
+        hw = std::thread::hardware_concurrency();
+        if (hw < 2) hw = 2; // Minimum 2 threads based on assignment
+    }
+
+    if (options.build_index) {
+        std::cout << "Indexing " << rootDir.string() << " into " << options.index_path.string() << std::endl;
+        long long indexed = buildTrigramIndex(rootDir, options.index_path, hw);
+        if (indexed < 0) {
+            return 1;
+        }
+        std::cout << "Indexed " << indexed << " files." << std::endl;
+        return 0;
+    }
+
+    // One literal pattern runs the fastest literal kernel for this CPU, several
+    // share one Aho-Corasick pass, and regular expressions run a lazy DFA. The
+    // case, word and invert modes are compiled into the matcher picked here.
+    std::unique_ptr<Matcher> matcher;
+    try {
+        matcher.reset(makeMatcher(patterns, options.syntax, options.match_options));
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Invalid regular expression: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // A regex can only be narrowed by the literals every match must contain;
+    // without them the index cannot rule anything out. Neither can it for an
+    // inverted search, where files without the pattern match everywhere.
+    std::vector<std::string> indexPatterns;
+    if (!options.match_options.invert) {
+        if (const RegexMatcher* regex = dynamic_cast<const RegexMatcher*>(matcher.get())) {
+            indexPatterns = regex->requiredLiterals();
+        } else {
+            indexPatterns = patterns;
+        }
+    }
+
+    // Use the index when there is one; files it does not cover are still searched
+    TrigramIndex trigramIndex;
+    std::unique_ptr<IndexQuery> indexQuery;
+    if (options.use_index && !indexPatterns.empty()) {
+        std::error_code ec;
+        std::string error;
+        if (!std::filesystem::exists(options.index_path, ec)) {
+            if (options.index_path != rootDir / DEFAULT_INDEX_NAME) {
+                std::cerr << "Index " << options.index_path.string() << " not found; searching every file" << std::endl;
+            }
+        } else if (!trigramIndex.open(options.index_path, error)) {
+            std::cerr << "Ignoring index " << options.index_path.string() << ": " << error << std::endl;
+        } else {
+            indexQuery.reset(new IndexQuery(trigramIndex, rootDir, indexPatterns));
+        }
+    }
+
+    // Reuse the previous run's results for files that have not changed
+    std::unique_ptr<Manifest> manifest;
+    if (!options.manifest_path.empty()) {
+        manifest.reset(new Manifest());
+        std::string error;
+        if (!manifest->load(options.manifest_path, rootDir, queryKey(options), error)) {
+            std::cerr << "Ignoring manifest " << options.manifest_path.string() << ": " << error << std::endl;
+        }
+    }
+    WalkRules rules(rootDir, options.include_globs, options.exclude_globs, options.use_gitignore);
+    SkipCounts skipped;
+    FileFilter filter(indexQuery.get(), manifest.get(), options.max_file_size, &skipped);
 
     // Print header
     std::cout << "----- Search Started -----" << std::endl;
     std::cout << "Target Folder: " << rootDir.string() << std::endl;
-    std::cout << "Target Text: " << target << std::endl;
+    if (patterns.size() == 1) {
+        std::cout << (options.syntax == patternSyntax::regex ? "Target Regex: " : "Target Text: ")
+                  << patterns[0] << std::endl;
+    } else {
+        std::cout << "Target Patterns: " << patterns.size() << std::endl;
+    }
+    const MatchOptions& mode = options.match_options;
+    if (mode.ignore_case || mode.whole_word || mode.invert) {
+        std::cout << "Matching:" << (mode.ignore_case ? " ignore-case" : "")
+                  << (mode.whole_word ? " whole-word" : "") << (mode.invert ? " invert" : "") << std::endl;
+    }
     std::cout << "Using a Pool of " << hw << " threads to search." << std::endl;
+    const CpuTopology topology = CpuTopology::detect();
+    PoolSettings poolSettings;
+    poolSettings.threads = hw;
+    poolSettings.pin = options.pin_threads;
+    poolSettings.numa = options.numa_groups;
+    poolSettings.adaptive = options.adaptive_pool && !options.fused;
+    if (options.numa_groups) {
+        std::cout << "Worker groups: " << std::min<std::size_t>(topology.nodes.size(), hw)
+                  << " (NUMA nodes: " << topology.nodes.size() << ", CPUs: " << topology.cpuCount() << ")" << std::endl;
+    }
+    if (indexQuery) {
+        std::cout << "Using index " << options.index_path.string() << ": " << indexQuery->skippableFiles()
+                  << " of " << trigramIndex.fileCount() << " indexed files cannot match." << std::endl;
+    }
 
-    // Create channels
-    channel<std::filesystem::path>* fileChan = makeChannel<std::filesystem::path>(/*buffer size*/ 64);
-    channel<Match>* resultChan = makeChannel<Match>(/*buffer size*/ 64);
-
-    // Start producer thread
-    std::thread producerThread(
-        producerThreadFunc,
-        rootDir,
-        fileChan    
-    );
-
-    // Start worker thread pool
-    std::vector<std::thread> workers;
-    workers.reserve(hw);
-    for (unsigned int i = 0; i < hw; ++i) {
-        workers.emplace_back(
-            workerThreadFunc,
-            fileChan,
-            resultChan,
-            std::ref(target)
-        
-        );
+    // Every thread started from here on keeps its own counters
+    SearchStats stats;
+    if (options.stats) {
+        SearchStats::enable(&stats);
     }
 
-    // Start printer thread
+    // Create result channel and start printer thread
+    channel<MatchSlab*>* resultChan = makeChannel<MatchSlab*>(/*buffer size*/ 64, options.channel_kind);
+    PrinterSettings printerSettings;
+    printerSettings.format = options.format;
+    printerSettings.mode = options.report_mode;
+    printerSettings.manifest = manifest.get();
+    printerSettings.patterns = patterns;
+    ReorderWindow reorderWindow;
+    if (options.sort_output) {
+        printerSettings.order = &reorderWindow;
+    }
     std::thread printerThread(
         printerThreadFunc,
-        resultChan
+        resultChan,
+        std::cref(printerSettings)
     );
 
-    // JOin producer thread
-    producerThread.join();
-
-    // Join worker threads
-    for (auto& worker : workers) {
-        worker.join();
+    ScanLimits limits;
+    limits.mode = options.report_mode;
+    limits.max_count = options.max_count;
+    limits.search_binary = options.search_binary;
+    limits.skipped = &skipped;
+    if (options.fused) {
+        fusedSearch(rootDir, resultChan, *matcher, limits, topology, poolSettings, rules, &filter);
+    } else {
+        runPipeline(options, *matcher, limits, resultChan, topology, poolSettings, rules, &filter, printerSettings.order);
+    }
+    if (manifest) {
+        manifest->replay(resultChan, limits.mode);
     }
 
     // CLose reuslt channel so printer exits
@@ -103,9 +362,29 @@ int main(int argc, char* argv[]) {
     printerThread.join();
 
     // Cleanup channels
-    delete fileChan;
+    if (options.stats) {
+        stats.addChannel("Result", resultChan->stats());
+    }
     delete resultChan;
 
+    if (manifest) {
+        if (!manifest->save(options.manifest_path)) {
+            std::cerr << "Error writing manifest " << options.manifest_path.string() << std::endl;
+        }
+        std::cout << "Manifest: " << manifest->reusedFiles() << " files reused, "
+                  << manifest->rescannedFiles() << " rescanned, "
+                  << manifest->removedFiles() << " removed." << std::endl;
+    }
+
+    if (options.stats) {
+        SearchStats::enable(nullptr);
+        stats.report(std::cout);
+    }
+    if (skipped.binary > 0 || skipped.too_large > 0) {
+        std::cout << "Skipped: " << skipped.binary << " binary files, "
+                  << skipped.too_large << " files over the size limit." << std::endl;
+    }
+
     // Print completion footer
     std::cout << "----- Search Complete -----" << std::endl;
     return 0;
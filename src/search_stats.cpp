@@ -0,0 +1,163 @@
+/**
+ * @file src/search_stats.cpp
+ *
+ * @brief Implementation of the --stats counters and report.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ */
+
+#include "search_stats.h"
+#include <cstring>
+#include <iomanip>
+
+SearchStats* SearchStats::active = nullptr;
+
+thread_local ThreadStats* currentThreadStats = nullptr;
+
+/**
+ * @brief Make stats the destination of every StatsScope opened from now on
+ *
+ * @param stats The collector, or nullptr to turn stats off
+ *
+ * @details Call before any thread is started; the run's elapsed time is
+ * measured from here.
+ */
+void SearchStats::enable(SearchStats* stats) {
+    if (stats) {
+        stats->started = std::chrono::steady_clock::now();
+    }
+    active = stats;
+}
+
+void SearchStats::add(const ThreadStats& stats) {
+    std::lock_guard<std::mutex> lk(mut);
+    threads.push_back(stats);
+}
+
+/**
+ * @brief Keep a channel's metrics for the report
+ *
+ * @param name How the report calls the channel
+ * @param stats The channel's stats(), taken once nothing uses it any more
+ *
+ * @details Does nothing unless the channels were built with CHANNEL_STATS.
+ */
+void SearchStats::addChannel(const std::string& name, const channelStats& stats) {
+    if (!channelStatsEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lk(mut);
+    channels.emplace_back(name, stats);
+}
+
+/**
+ * @brief Milliseconds in a duration, for printing
+ */
+static double millis(std::chrono::nanoseconds d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+/**
+ * @brief Print one channel's transfers, waits and depth histogram
+ */
+static void reportChannel(std::ostream& out, const std::string& name, const channelStats& c) {
+    if (!c.recorded) {
+        out << name << " channel: not recorded (lock-free channels keep no metrics)" << std::endl;
+        return;
+    }
+    out << name << " channel: " << c.transferred << " items, "
+        << c.senderWaits << " sends waited " << millis(c.senderWaitTime) << " ms, "
+        << c.receiverWaits << " receives waited " << millis(c.receiverWaitTime) << " ms" << std::endl;
+    out << "  depth at send:";
+    // Stop after the deepest bucket that was ever hit
+    std::size_t last = 0;
+    for (std::size_t b = 0; b < CHANNEL_DEPTH_BUCKETS; ++b) {
+        if (c.depthHistogram[b]) last = b;
+    }
+    for (std::size_t b = 0; b <= last; ++b) {
+        std::size_t lo = b == 0 ? 0 : std::size_t(1) << (b - 1);
+        std::size_t hi = b == 0 ? 0 : (std::size_t(1) << b) - 1;
+        out << ' ' << lo;
+        if (b + 1 == CHANNEL_DEPTH_BUCKETS) {
+            out << '+';
+        } else if (hi != lo) {
+            out << '-' << hi;
+        }
+        out << ':' << c.depthHistogram[b];
+    }
+    out << std::endl;
+}
+
+void SearchStats::report(std::ostream& out) const {
+    std::lock_guard<std::mutex> lk(mut);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    ThreadStats total;
+    for (const ThreadStats& t : threads) {
+        total.files_walked += t.files_walked;
+        // The read-ahead stage passes on files the walker already sent
+        if (std::strcmp(t.role, "reader") != 0) total.files_sent += t.files_sent;
+        total.files_searched += t.files_searched;
+        total.bytes_searched += t.bytes_searched;
+        total.matches_found += t.matches_found;
+        total.matches_printed += t.matches_printed;
+        total.file_send_wait += t.file_send_wait;
+        total.file_receive_wait += t.file_receive_wait;
+        total.result_send_wait += t.result_send_wait;
+        total.result_receive_wait += t.result_receive_wait;
+    }
+    const double megabytes = static_cast<double>(total.bytes_searched) / (1 << 20);
+
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << "----- Statistics -----" << std::endl;
+    out << "Elapsed: " << seconds * 1000 << " ms" << std::endl;
+    out << "Files: " << total.files_walked << " walked, " << total.files_sent << " sent, "
+        << total.files_searched << " searched" << std::endl;
+    out << "Bytes searched: " << total.bytes_searched << " (" << (seconds > 0 ? megabytes / seconds : 0)
+        << " MB/s, " << (seconds > 0 ? total.files_searched / seconds : 0) << " files/s)" << std::endl;
+    out << "Matches: " << total.matches_found << " found, " << total.matches_printed << " printed" << std::endl;
+    out << "File channel blocked: send " << millis(total.file_send_wait) << " ms, receive "
+        << millis(total.file_receive_wait) << " ms" << std::endl;
+    out << "Result channel blocked: send " << millis(total.result_send_wait) << " ms, receive "
+        << millis(total.result_receive_wait) << " ms" << std::endl;
+
+    out << std::left << std::setw(8) << "thread" << std::setw(9) << "role" << std::right
+        << std::setw(11) << "busy ms" << std::setw(11) << "waiting ms" << std::setw(11) << "blocked ms"
+        << std::setw(9) << "files" << std::setw(14) << "bytes" << std::setw(10) << "matches" << std::endl;
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        const ThreadStats& t = threads[i];
+        std::chrono::nanoseconds waiting = t.file_receive_wait + t.result_receive_wait + t.steal_wait;
+        std::chrono::nanoseconds blocked = t.file_send_wait + t.result_send_wait;
+        std::chrono::nanoseconds busy = t.alive - waiting - blocked;
+        if (busy.count() < 0) busy = std::chrono::nanoseconds(0);
+        std::uint64_t files = t.files_searched ? t.files_searched : t.files_sent;
+        std::uint64_t matches = t.matches_printed ? t.matches_printed : t.matches_found;
+        out << std::left << std::setw(8) << i << std::setw(9) << t.role << std::right
+            << std::setw(11) << millis(busy) << std::setw(11) << millis(waiting) << std::setw(11) << millis(blocked)
+            << std::setw(9) << files << std::setw(14) << t.bytes_searched << std::setw(10) << matches << std::endl;
+    }
+    for (const auto& channel : channels) {
+        reportChannel(out, channel.first, channel.second);
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+StatsScope::StatsScope(const char* role) : target(SearchStats::enabled()) {
+    if (target) {
+        counters.role = role;
+        opened = std::chrono::steady_clock::now();
+        currentThreadStats = &counters;
+    }
+}
+
+StatsScope::~StatsScope() {
+    if (target) {
+        counters.alive = std::chrono::steady_clock::now() - opened;
+        currentThreadStats = nullptr;
+        target->add(counters);
+    }
+}
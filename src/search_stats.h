@@ -0,0 +1,161 @@
+/**
+ * @file src/search_stats.h
+ *
+ * @brief Declaration of the per-thread counters behind --stats.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of ThreadStats, the counters one
+ * thread keeps about its part of the search, and SearchStats, which merges
+ * them once the threads are done and prints the report. Each walker, worker,
+ * fused pool and printer thread opens a StatsScope for its lifetime; while it
+ * is open threadStats() returns that thread's own ThreadStats, so counting
+ * is a plain increment with no shared atomics or locks. Only when the scope
+ * closes are the counters merged, under a mutex. Without --stats no
+ * SearchStats is enabled, threadStats() returns nullptr and no clock is read.
+ *
+ * When the channels are built with CHANNEL_STATS, the pipeline also hands
+ * over each channel's own channelStats before deleting it, and the report
+ * adds the channel's depth histogram and wait counts.
+ */
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "channel.h"
+
+/**
+ * @struct ThreadStats
+ *
+ * @brief What one thread did during the search
+ *
+ * @var role "walker", "reader", "worker", "fused" or "printer"
+ * @var alive How long the thread ran
+ * @var files_walked Regular files seen while listing directories
+ * @var files_sent Files handed on to be searched
+ * @var files_searched Files opened and scanned
+ * @var bytes_searched Bytes of the files (or chunks) scanned
+ * @var matches_found Matching lines found
+ * @var matches_printed Matches or summaries printed
+ * @var file_send_wait Time blocked sending to the file channel
+ * @var file_receive_wait Time blocked receiving from the file channel
+ * @var result_send_wait Time blocked sending to the result channel
+ * @var result_receive_wait Time blocked receiving from the result channel
+ * @var steal_wait Time spent looking for work to steal, or backing off
+ */
+struct ThreadStats {
+    const char* role = "";
+    std::chrono::nanoseconds alive{0};
+    std::uint64_t files_walked = 0;
+    std::uint64_t files_sent = 0;
+    std::uint64_t files_searched = 0;
+    std::uint64_t bytes_searched = 0;
+    std::uint64_t matches_found = 0;
+    std::uint64_t matches_printed = 0;
+    std::chrono::nanoseconds file_send_wait{0};
+    std::chrono::nanoseconds file_receive_wait{0};
+    std::chrono::nanoseconds result_send_wait{0};
+    std::chrono::nanoseconds result_receive_wait{0};
+    std::chrono::nanoseconds steal_wait{0};
+};
+
+/**
+ * @class SearchStats
+ *
+ * @brief Collects the ThreadStats of every thread and prints the report
+ *
+ * @details enable() makes a SearchStats the destination of every StatsScope
+ * opened afterwards; it must outlive those threads. report() prints totals,
+ * throughput over the time since enable(), the time spent blocked on each
+ * channel, and one line per thread with its busy and waiting time. Busy
+ * time is the thread's lifetime minus its channel and stealing waits.
+ * Channels added with addChannel() get a section of their own.
+ */
+class SearchStats {
+public:
+    static void enable(SearchStats* stats);
+    static SearchStats* enabled() { return active; }
+
+    void add(const ThreadStats& stats);
+    void addChannel(const std::string& name, const channelStats& stats);
+    void report(std::ostream& out) const;
+
+private:
+    static SearchStats* active;
+
+    mutable std::mutex mut;
+    std::vector<ThreadStats> threads;
+    std::vector<std::pair<std::string, channelStats>> channels;
+    std::chrono::steady_clock::time_point started;
+};
+
+// The calling thread's counters while a StatsScope is open with stats enabled
+extern thread_local ThreadStats* currentThreadStats;
+
+/**
+ * @brief The calling thread's counters, or nullptr when stats are off
+ */
+inline ThreadStats* threadStats() {
+    return currentThreadStats;
+}
+
+/**
+ * @class StatsScope
+ *
+ * @brief Gives the calling thread its own counters for the scope's lifetime
+ *
+ * @details Does nothing unless a SearchStats is enabled. On destruction the
+ * thread's lifetime is recorded and its counters are added to the
+ * SearchStats.
+ */
+class StatsScope {
+public:
+    explicit StatsScope(const char* role);
+    ~StatsScope();
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+private:
+    ThreadStats counters;
+    SearchStats* target;
+    std::chrono::steady_clock::time_point opened;
+};
+
+/**
+ * @class StatsTimer
+ *
+ * @brief Adds the time until it goes out of scope to one of the calling thread's counters
+ *
+ * @details Reads the clock only when the thread has counters.
+ */
+class StatsTimer {
+public:
+    explicit StatsTimer(std::chrono::nanoseconds ThreadStats::*field)
+        : stats(threadStats()), field(field) {
+        if (stats) started = std::chrono::steady_clock::now();
+    }
+    ~StatsTimer() {
+        if (stats) stats->*field += std::chrono::steady_clock::now() - started;
+    }
+
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+private:
+    ThreadStats* stats;
+    std::chrono::nanoseconds ThreadStats::*field;
+    std::chrono::steady_clock::time_point started;
+};
+
+#endif // SEARCH_STATS_H
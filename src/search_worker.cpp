@@ -13,104 +13,816 @@
  * processes file paths received from a channel, searches each file for a
  * specified target string, and sends any matches to a result channel. It also
  * includes the implementation of the printer thread function that receives
- * Match objects from the result channel and prints their details to the console.
+ * match slabs from the result channel and prints their details to the console.
  */
 
 
 #include "search_worker.h"
-#include <fstream>
+#include "file_buffer.h"
+#include "match_pool.h"
+#include "output_writer.h"
+#include "search_stats.h"
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+// Matching lines a scan collects under one SIGBUS guard before they go into the slab
+constexpr std::size_t HIT_BATCH = 256;
+
+/**
+ * @struct LineHit
+ * 
+ * @brief A matching line found in a mapped file, not yet copied out of it
+ */
+struct LineHit {
+    const char* begin;
+    const char* end;
+    long long line_number;
+    std::size_t pattern;
+};
+
+/**
+ * @brief Find every matching line in a range of a file buffer
+ * 
+ * @param file The buffer the range is in
+ * @param scanBegin Start of the range; must be the start of a line
+ * @param scanEnd End of the range; lines are cut off here
+ * @param countFrom Line 1 starts here; line numbers count newlines from this point
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param limit Stop after this many matching lines
+ * @param slab Each match found is appended here
+ * 
+ * @return false if the file shrank under its mapping; slab then holds part of the matches
+ * 
+ * @details The raw bytes are searched directly instead of copying each line
+ * out. Line boundaries and line numbers are only computed when a hit is
+ * found: the newlines between the previous hit and the new one are counted,
+ * and the line is sliced out of the buffer. After a hit the search resumes at
+ * the start of the next line so each line is reported at most once.
+ * 
+ * A SIGBUS leaves FileBuffer::read() without unwinding, so nothing with a
+ * destructor may be live in the frames it leaves. The scan therefore runs in
+ * two steps per HIT_BATCH lines: under read() the matcher and the line
+ * search only load bytes and note each line in a plain array; the slab then
+ * grows outside read() to hold them, and a second read() only copies bytes
+ * into the room made. The matchers' find functions keep plain locals only;
+ * RegexMatcher grows its DFA cache in step(), which reads no file bytes, so
+ * a fault never lands in the middle of that.
+ */
+static bool scanRange(
+    const FileBuffer& file,
+    const char* scanBegin,
+    const char* scanEnd,
+    const char* countFrom,
+    const Matcher& matcher,
+    std::size_t limit,
+    MatchSlab& slab
+) {
+    LineHit hits[HIT_BATCH];
+    const char* cursor = scanBegin;   // always at the start of a line
+    const char* counted = countFrom;  // newlines before this point are in lineNumber
+    long long lineNumber = 1;
+    std::size_t found = 0;
+    while (true) {
+        std::size_t batched = 0;
+        bool scanned = file.read([&] {
+            while (cursor < scanEnd && found < limit && batched < HIT_BATCH) {
+                std::size_t pattern = 0;
+                const char* hit = matcher.findPattern(cursor, scanEnd, pattern);
+                if (!hit) {
+                    cursor = scanEnd;
+                    break;
+                }
+
+                // Widen the hit to its enclosing line
+                const char* lineStart = cursor;
+                if (hit > cursor) {
+                    const void* nl = memrchr(cursor, '\n', hit - cursor);
+                    if (nl) lineStart = static_cast<const char*>(nl) + 1;
+                }
+                const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', scanEnd - hit));
+                if (!lineEnd) lineEnd = scanEnd;
+
+                lineNumber += std::count(counted, lineStart, '\n');
+                counted = lineStart;
+
+                hits[batched++] = LineHit{lineStart, lineEnd, lineNumber, pattern};
+                ++found;
+
+                cursor = lineEnd + 1;
+            }
+        });
+        if (!scanned) {
+            return false;
+        }
+        if (batched == 0) {
+            return true;
+        }
+
+        // Make room for the lines first, so the copy below only moves bytes
+        std::size_t textStart = slab.text.size();
+        std::size_t textEnd = textStart;
+        for (std::size_t i = 0; i < batched; ++i) {
+            Match m;
+            m.line_number = static_cast<int>(hits[i].line_number);
+            m.pattern = static_cast<std::uint32_t>(hits[i].pattern);
+            m.text_offset = textEnd;
+            m.text_length = static_cast<std::size_t>(hits[i].end - hits[i].begin);
+            slab.matches.push_back(m);
+            textEnd += m.text_length;
+        }
+        slab.text.resize(textEnd);
+        char* text = slab.text.data() + textStart;
+        bool copied = file.read([&] {
+            for (std::size_t i = 0; i < batched; ++i) {
+                std::size_t length = static_cast<std::size_t>(hits[i].end - hits[i].begin);
+                std::memcpy(text, hits[i].begin, length);
+                text += length;
+            }
+        });
+        if (!copied) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Count the matching lines in a range of a file buffer
+ * 
+ * @param scanBegin Start of the range; must be the start of a line
+ * @param scanEnd End of the range
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param limit Stop counting at this many matching lines
+ * 
+ * @return std::size_t The number of matching lines, at most limit
+ * 
+ * @details Used when only a per-file summary is reported: neither line
+ * numbers nor match slabs are filled, and the scan ends at the limit.
+ */
+static std::size_t countRange(
+    const char* scanBegin,
+    const char* scanEnd,
+    const Matcher& matcher,
+    std::size_t limit
+) {
+    std::size_t found = 0;
+    const char* cursor = scanBegin;
+    while (cursor < scanEnd && found < limit) {
+        const char* hit = matcher.find(cursor, scanEnd);
+        if (!hit) {
+            break;
+        }
+        ++found;
+        const char* lineEnd = static_cast<const char*>(std::memchr(hit, '\n', scanEnd - hit));
+        if (!lineEnd) {
+            break;
+        }
+        cursor = lineEnd + 1;
+    }
+    return found;
+}
+
+/**
+ * @brief The most matching lines worth finding in one file
+ */
+static std::size_t lineLimit(const ScanLimits& limits) {
+    if (limits.mode == reportMode::files) {
+        return 1;
+    }
+    return limits.max_count > 0 ? limits.max_count : SIZE_MAX;
+}
+
+/**
+ * @brief Whether a file is skipped as binary; counted when count is set
+ * 
+ * @param skip Set to whether the file is skipped
+ * 
+ * @return false if the file shrank under its mapping while its start was read
+ */
+static bool skipAsBinary(const FileBuffer& file, const ScanLimits& limits, bool count, bool& skip) {
+    skip = false;
+    if (limits.search_binary) {
+        return true;
+    }
+    if (!file.read([&] { skip = file.looksBinary(); })) {
+        return false;
+    }
+    if (skip && count && limits.skipped) {
+        limits.skipped->binary.fetch_add(1);
+    }
+    return true;
+}
+
+/**
+ * @class SpareSlab
+ * 
+ * @brief The slab a searching thread fills with the matches of its current file
+ * 
+ * @details Each thread keeps one slab from the pool between files. Only a
+ * slab that is sent is replaced, so files without matches never touch the
+ * pool's lock, and the slab goes back to the pool when the thread exits.
+ */
+class SpareSlab {
+public:
+    ~SpareSlab() {
+        if (slab) matchSlabPool().release(slab);
+    }
+
+    // An empty slab for the next file
+    MatchSlab& get() {
+        if (!slab) {
+            slab = matchSlabPool().acquire();
+        }
+        slab->clear();
+        return *slab;
+    }
+
+    // Hand the slab over to be sent; the next get() takes a new one
+    MatchSlab* take() {
+        MatchSlab* sent = slab;
+        slab = nullptr;
+        return sent;
+    }
+
+private:
+    MatchSlab* slab = nullptr;
+};
+
+static thread_local SpareSlab spareSlab;
+
+/**
+ * @struct FileReport
+ * 
+ * @brief What the calling thread still owes the printer for its current task
+ * 
+ * @var sequence Number of the file being searched, NO_SEQUENCE unless sorting
+ * @var owed This task must still send a slab for the file (--sort only)
+ * @var chunk_reported A chunk task has reached finishChunk
+ * 
+ * @details With --sort the printer waits for every numbered file, so a file
+ * must report exactly once even without matches: by the whole-file task, or
+ * by whichever chunk finishes last. sendSlab() stamps the sequence number
+ * and settles the debt; workerThreadFunc sends an empty slab for any still
+ * owed. A chunk that failed before reporting is reported for, so neither the
+ * other chunks' matches nor, with --sort, the printer wait on it forever.
+ */
+struct FileReport {
+    std::uint64_t sequence = NO_SEQUENCE;
+    bool owed = false;
+    bool chunk_reported = false;
+};
+
+static thread_local FileReport fileReport;
+
+// The calling worker's handle on its pool, if it runs in one, so sends count as waiting
+static thread_local PoolWorker* poolWorker = nullptr;
+
+/**
+ * @brief Stamp a filled slab with its file and send it to the printer
+ */
+static void sendSlab(MatchSlab* slab, const std::filesystem::path& filePath, channel<MatchSlab*>* resultChan) {
+    slab->thread_id = std::this_thread::get_id();
+    slab->file_path = filePath;
+    slab->sequence = fileReport.sequence;
+    fileReport.owed = false;
+    StatsTimer timer(&ThreadStats::result_send_wait);
+    // A full result channel means the printer is behind, which more workers cannot fix
+    if (poolWorker) poolWorker->beginWait();
+    resultChan->send(slab);
+    if (poolWorker) poolWorker->endWait();
+}
+
+/**
+ * @brief Send the summary of a file with hits matching lines
+ */
+static void sendSummary(
+    const std::filesystem::path& filePath,
+    std::size_t hits,
+    channel<MatchSlab*>* resultChan
+) {
+    if (hits == 0) {
+        return;
+    }
+    spareSlab.get().count = hits;
+    sendSlab(spareSlab.take(), filePath, resultChan);
+}
+
+/**
+ * @brief Count one scanned file or chunk in the calling thread's stats
+ */
+static void countScan(bool newFile, std::size_t bytes, std::size_t found) {
+    if (ThreadStats* stats = threadStats()) {
+        if (newFile) ++stats->files_searched;
+        stats->bytes_searched += bytes;
+        stats->matches_found += found;
+    }
+}
+
+/**
+ * @brief Report a mapped file that was truncated while it was being searched
+ */
+static void warnTruncated(const std::filesystem::path& filePath) {
+    std::cerr << "Skipping " << filePath.string() << ": file shrank while it was being searched" << std::endl;
+}
+
+/**
+ * @brief Search the whole of a loaded file and send its matches
+ * 
+ * @details Scans all of the file with scanRange into the thread's spare
+ * slab, which is sent once the scan is done if it holds any matches. For
+ * files and counts only a summary is sent. A file that looks binary is
+ * dropped after its first block is checked, and a file truncated during the
+ * scan is dropped with a warning.
+ */
+static void searchBuffer(
+    const FileBuffer& file,
+    const std::filesystem::path& filePath,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
+) {
+    bool binary = false;
+    if (!skipAsBinary(file, limits, true, binary)) {
+        warnTruncated(filePath);
+        return;
+    }
+    if (binary) {
+        return;
+    }
+
+    const char* begin = file.data();
+    if (limits.mode != reportMode::lines) {
+        std::size_t hits = 0;
+        if (!file.read([&] { hits = countRange(begin, begin + file.size(), matcher, lineLimit(limits)); })) {
+            warnTruncated(filePath);
+            return;
+        }
+        countScan(true, file.size(), hits);
+        sendSummary(filePath, hits, resultChan);
+        return;
+    }
+
+    MatchSlab& slab = spareSlab.get();
+    if (!scanRange(file, begin, begin + file.size(), begin, matcher, lineLimit(limits), slab)) {
+        warnTruncated(filePath);
+        return;
+    }
+    countScan(true, file.size(), slab.matches.size());
+
+    if (!slab.matches.empty()) {
+        sendSlab(spareSlab.take(), filePath, resultChan);
+    }
+}
 
 /**
  * @brief Search a file for the target string and send matches to the result channel
  * 
  * @param filePath The path of the file to search
- * @param target The target string to search for
- * @param resultChan The channel to send Match objects through
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param resultChan The channel to send match slabs through
  * 
  * @return void
  * 
- * @details This function opens the specified file and reads it line by line.
- * For each line that contains the target string, it creates a Match object
- * and sends it through the provided result channel.
+ * @details This function loads the whole file through a FileBuffer (mapped
+ * when possible, block-read otherwise) and searches it with searchBuffer.
  */
-static void searchFileForTarget(
+void searchFileForTarget(
     const std::filesystem::path& filePath,
-    const std::string& target,
-    channel<Match>* resultChan
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
 ) {
-    // file searching logic line by line
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    FileBuffer file(filePath);
+    if (!file.isOpen()) {
         return; // Could not open file due to permissions or other issues
     }
+    searchBuffer(file, filePath, matcher, limits, resultChan);
+}
 
-    std::string line;
-    int lineNumber = 0;
-    while (std::getline(file, line)) {
-        lineNumber++;
-        if (line.find(target) != std::string::npos) {
-            Match m;
-            m.thread_id = std::this_thread::get_id();
-            m.file_path = filePath;
-            m.line_number = lineNumber;
-            m.line_content = line;
-            resultChan->send(m);
+/**
+ * @brief Record one finished chunk; the last chunk sends the whole file's matches
+ * 
+ * @param task The chunk task that finished
+ * @param newlines Newlines in the chunk's byte range
+ * @param matches The chunk's matches, numbered from the chunk start, or nullptr
+ * @param hits The chunk's matching lines, when only a summary is reported
+ * @param limits When to stop searching and what to report
+ * @param resultChan The channel to send match slabs through
+ * 
+ * @return void
+ * 
+ * @details The worker that completes the last chunk adds the newline counts of
+ * all earlier chunks to each chunk's line numbers and sends every match of the
+ * file, in file order, as one slab, cut off at the line limit. The first
+ * chunk slab with matches becomes that slab; the matches of later chunks are
+ * appended to it and their slabs go back to the pool. For files and counts
+ * it sends the summary of the chunks' hits instead.
+ */
+static void finishChunk(
+    const FileTask& task,
+    std::uint64_t newlines,
+    MatchSlab* matches,
+    std::size_t hits,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
+) {
+    SplitFile& split = *task.split;
+    const std::size_t limit = lineLimit(limits);
+    MatchSlab* all = nullptr;
+    fileReport.chunk_reported = true;
+    {
+        std::lock_guard<std::mutex> lk(split.mut);
+        split.newline_counts[task.chunk_index] = newlines;
+        split.chunk_slabs[task.chunk_index] = matches;
+        split.hits += hits;
+        if (++split.chunks_done < split.chunk_count) {
+            return;
+        }
+        fileReport.owed = task.sequence != NO_SEQUENCE;
+
+        if (limits.mode != reportMode::lines) {
+            hits = std::min(split.hits, limit);
+        }
+        std::uint64_t linesBefore = 0;
+        for (std::size_t i = 0; i < split.chunk_count; ++i) {
+            MatchSlab* chunk = split.chunk_slabs[i];
+            split.chunk_slabs[i] = nullptr;
+            if (chunk && !all) {
+                all = chunk;
+                if (all->matches.size() > limit) all->matches.resize(limit);
+                for (Match& m : all->matches) {
+                    m.line_number = static_cast<int>(m.line_number + linesBefore);
+                }
+            } else if (chunk) {
+                for (const Match& m : chunk->matches) {
+                    if (all->matches.size() == limit) break;
+                    std::string_view line = chunk->line(m);
+                    all->add(static_cast<int>(m.line_number + linesBefore), m.pattern,
+                             line.data(), line.data() + line.size());
+                }
+                matchSlabPool().release(chunk);
+            }
+            linesBefore += split.newline_counts[i];
+        }
+    }
+
+    if (limits.mode != reportMode::lines) {
+        sendSummary(task.path, hits, resultChan);
+    } else if (all) {
+        sendSlab(all, task.path, resultChan);
+    }
+}
+
+/**
+ * @brief Search one task (a whole file or one chunk of a large file)
+ * 
+ * @param task The task to search
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param limits When to stop searching and what to report
+ * @param resultChan The channel to send match slabs through
+ * 
+ * @return void
+ * 
+ * @details A task whose contents were already read is searched in memory;
+ * other whole-file tasks go straight to searchFileForTarget. For a chunk,
+ * the scan starts at the first line that begins inside the chunk and stops
+ * at the end of the last line that begins inside it, so lines that cross a
+ * chunk boundary are searched exactly once, by the chunk they start in. The
+ * newlines in the chunk's exact byte range are counted so line numbers can be
+ * reconciled across chunks by finishChunk. A chunk always reports back, even
+ * if the file can no longer be opened, so the other chunks' matches are not
+ * held forever. A file that cannot be mapped is read only around the chunk. When only a summary is reported the chunk counts matching
+ * lines instead, and skips its search once earlier-finished chunks have
+ * already reached the limit. Every chunk checks the start of the file and
+ * finds nothing if it looks binary; only the first chunk counts the skip.
+ */
+void searchFileTask(
+    const FileTask& task,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
+) {
+    fileReport = FileReport{task.sequence, task.sequence != NO_SEQUENCE && !task.split, false};
+    if (task.contents) {
+        searchBuffer(*task.contents, task.path, matcher, limits, resultChan);
+        return;
+    }
+    if (!task.split) {
+        searchFileForTarget(task.path, matcher, limits, resultChan);
+        return;
+    }
+
+    // Line numbers do not matter for a summary, so a chunk that cannot change it reports at once
+    const bool summary = limits.mode != reportMode::lines;
+    if (summary) {
+        std::unique_lock<std::mutex> lk(task.split->mut);
+        if (task.split->hits >= lineLimit(limits)) {
+            lk.unlock();
+            finishChunk(task, 0, nullptr, 0, limits, resultChan);
+            return;
         }
     }
+
+    MatchSlab* matches = nullptr;
+    std::uint64_t newlines = 0;
+    std::size_t hits = 0;
+    FileBuffer file(task.path, task.offset, task.length);
+    if (file.isOpen() && task.offset < file.offset() + file.size()) {
+        // begin is the start of the file when it is mapped, else just before the chunk
+        const char* begin = file.data();
+        const char* end = begin + file.size();
+        const char* chunkBegin = begin + (task.offset - file.offset());
+        const char* chunkEnd = begin + (std::min<std::uintmax_t>(task.offset + task.length, file.offset() + file.size()) - file.offset());
+        const char* scanBegin = chunkBegin;
+        const char* scanEnd = chunkEnd;
+        bool binary = false;
+        bool scanned = skipAsBinary(file, limits, task.chunk_index == 0, binary);
+        if (scanned && !binary) {
+            scanned = file.read([&] {
+                // The line running into this chunk belongs to the previous one
+                if (chunkBegin > begin && chunkBegin[-1] != '\n') {
+                    const void* nl = std::memchr(chunkBegin, '\n', chunkEnd - chunkBegin);
+                    scanBegin = nl ? static_cast<const char*>(nl) + 1 : chunkEnd;
+                }
+                // The last line starting in this chunk may run past it
+                if (chunkEnd < end && chunkEnd[-1] != '\n') {
+                    const void* nl = std::memchr(chunkEnd, '\n', end - chunkEnd);
+                    scanEnd = nl ? static_cast<const char*>(nl) : end;
+                }
+                if (summary) {
+                    hits = countRange(scanBegin, scanEnd, matcher, lineLimit(limits));
+                } else {
+                    newlines = static_cast<std::uint64_t>(std::count(chunkBegin, chunkEnd, '\n'));
+                }
+            });
+        }
+        if (scanned && !binary && !summary) {
+            MatchSlab& slab = spareSlab.get();
+            scanned = scanRange(file, scanBegin, scanEnd, chunkBegin, matcher, lineLimit(limits), slab);
+            hits = slab.matches.size();
+        }
+
+        if (!scanned) {
+            // The chunk reports nothing so the other chunks can still finish the file
+            warnTruncated(task.path);
+            newlines = 0;
+            hits = 0;
+        } else if (!binary) {
+            if (!summary && hits > 0) {
+                matches = spareSlab.take();
+            }
+            countScan(task.chunk_index == 0, static_cast<std::size_t>(chunkEnd - chunkBegin), hits);
+        }
+    }
+
+    finishChunk(task, newlines, matches, summary ? hits : 0, limits, resultChan);
+}
+
+/**
+ * @brief Search one task and settle what it owes the printer, whatever happens
+ * 
+ * @details An error while searching is reported on std::cerr and does not
+ * propagate. A chunk that failed before reporting is reported for, and with
+ * --sort a file without matches sends its empty slab.
+ */
+void runFileTask(
+    const FileTask& task,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
+) {
+    try {
+        searchFileTask(task, matcher, limits, resultChan);
+    } catch (const std::exception& e) {
+        // A failure on one file should not end the thread
+        std::cerr << "Error searching " << task.path.string() << ": " << e.what() << std::endl;
+        if (task.split && !fileReport.chunk_reported) {
+            finishChunk(task, 0, nullptr, 0, limits, resultChan);
+        }
+    }
+    if (fileReport.owed) {
+        // Nothing matched, but a sorted printer still waits for this file
+        spareSlab.get();
+        sendSlab(spareSlab.take(), task.path, resultChan);
+    }
 }
 
 /**
  * @brief Worker thread to process files from the file channel and search for the target string
  * 
- * @param fileChan The channel to receive file paths from
- * @param resultChan The channel to send Match objects through
- * @param target The target string to search for
+ * @param fileChan The channel to receive file tasks from
+ * @param resultChan The channel to send match slabs through
+ * @param matcher The matcher for the target string
+ * @param limits When to stop searching a file and what to report
  * 
  * @return void
  * 
- * @details This function continuously receives file paths from the file channel,
- * searches each file for the target string using the searchFileForTarget helper,
- * and sends any matches to the result channel. It stops when the file channel is closed.
+ * @details This function continuously receives up to WORKER_BATCH_SIZE tasks at a
+ * time from the file channel, searches each file or chunk for the target string using
+ * runFileTask, and sends any matches to the result channel. It
+ * stops when the file channel is closed and drained. An error while searching one
+ * file is reported on std::cerr and the worker moves on to the next file.
  */
 void workerThreadFunc(
-    channel<std::filesystem::path>* fileChan,
-    channel<Match>* resultChan,
-    const std::string& target
+    channel<FileTask>* fileChan,
+    channel<MatchSlab*>* resultChan,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    PoolWorker* control
 ) {
-    while (true) {
-        try {
-            auto filePath = fileChan->receive();
-            searchFileForTarget(filePath, target, resultChan);
-        } catch (...) {
-            // Assume exception means channel is closed
-            break;
+    StatsScope statsScope("worker");
+    poolWorker = control;
+    std::vector<FileTask> tasks;
+    tasks.reserve(WORKER_BATCH_SIZE);
+    while (!control || !control->retire()) {
+        {
+            // receiveBatch returns 0 only once the channel is closed and drained
+            StatsTimer timer(&ThreadStats::file_receive_wait);
+            if (control) control->beginWait();
+            std::size_t received = fileChan->receiveBatch(tasks, WORKER_BATCH_SIZE);
+            if (control) control->endWait();
+            if (received == 0) {
+                break;
+            }
+        }
+        for (const FileTask& task : tasks) {
+            runFileTask(task, matcher, limits, resultChan);
+        }
+        tasks.clear();
+    }
+}
+
+/**
+ * @brief Text printed for a thread id, computed once per worker thread
+ * 
+ * @details std::thread::id can only be formatted through a stream, which is
+ * too slow to set up for every match. There are only a handful of workers,
+ * so a short list searched linearly is enough.
+ */
+static const std::string& threadIdText(
+    std::vector<std::pair<std::thread::id, std::string>>& cache,
+    std::thread::id id
+) {
+    for (const auto& entry : cache) {
+        if (entry.first == id) return entry.second;
+    }
+    std::ostringstream text;
+    text << id;
+    cache.emplace_back(id, text.str());
+    return cache.back().second;
+}
+
+/**
+ * @brief Format one matching line
+ * 
+ * @param out Where the text goes
+ * @param settings Output format and pattern list
+ * @param file The path of the file the line is in
+ * @param threadName The thread that searched the file; only used by the verbose format
+ * @param line The text of the line
+ * @param m The match
+ */
+static void printMatch(
+    OutputWriter& out,
+    const PrinterSettings& settings,
+    const std::string& file,
+    const std::string* threadName,
+    std::string_view line,
+    const Match& m
+) {
+    const std::size_t patternCount = settings.patterns.size();
+    if (settings.format == outputFormat::compact) {
+        out.write(file);
+        out.write(':');
+        out.writeNumber(m.line_number);
+        out.write(':');
+        if (patternCount > 1 && m.pattern < patternCount) {
+            out.write(settings.patterns[m.pattern]);
+            out.write(':');
         }
+        out.write(line);
+        out.write('\n');
+        return;
     }
+    out.write("----------\nThread ");
+    out.write(*threadName);
+    out.write(" found a match.\nFile: \"");
+    out.write(file);
+    if (patternCount > 1 && m.pattern < patternCount) {
+        out.write("\"\nPattern: ");
+        out.write(settings.patterns[m.pattern]);
+        out.write("\nLine ");
+    } else {
+        out.write("\"\nLine ");
+    }
+    out.writeNumber(m.line_number);
+    out.write(": ");
+    out.write(line);
+    out.write("\n----------\n");
 }
 
 /**
- * @brief Printer thread to receive Match objects from the result channel and print them
+ * @brief Printer thread to receive match slabs from the result channel and print them
  * 
- * @param resultChan The channel to receive Match objects from
+ * @param resultChan The channel to receive match slabs from
+ * @param settings Output format, manifest and pattern list
  * 
  * @return void
  * 
- * @details This function continuously receives Match objects from the result channel
- * and prints their details to the console. It stops when the result channel is closed.
+ * @details This function continuously receives batches of up to PRINTER_BATCH_SIZE
+ * slabs from the result channel and formats their matches into an OutputWriter,
+ * which writes to standard output in large chunks. Every slab of a batch goes
+ * back to the slab pool, under one lock, once it has been formatted. While
+ * output is buffered the printer waits for more matches only until the
+ * writer's flush deadline, so results still show up promptly when matches
+ * trickle in. It stops when the result channel is closed and drained, writing
+ * out whatever is left.
  */
-void printerThreadFunc(channel<Match>* resultChan) {
-    try {
-        while (true) {
-            Match m = resultChan->receive();
-            
-            std::cout << "----------" << std::endl;
-            std::cout << "Thread " << m.thread_id << " found a match." << std::endl;
-            std::cout << "File: \"" << m.file_path.string() << "\"" << std::endl;
-            std::cout << "Line " << m.line_number << ": " << m.line_content << std::endl;
-            std::cout << "----------" << std::endl;
-        }
-    } catch (...) {
-        // Assume exception means channel is closed
-    }
-}
\ No newline at end of file
+void printerThreadFunc(channel<MatchSlab*>* resultChan, const PrinterSettings& settings) {
+    StatsScope statsScope("printer");
+    ThreadStats* stats = threadStats();
+    Manifest* manifest = settings.manifest;
+    OutputWriter out(STDOUT_FILENO);
+    std::vector<std::pair<std::thread::id, std::string>> threadNames;
+    std::vector<MatchSlab*> slabs;
+    slabs.reserve(PRINTER_BATCH_SIZE);
+    ReorderWindow* order = settings.order;
+    ReorderBuffer reorder(order ? REORDER_WINDOW : 0);
+    std::vector<MatchSlab*> arrived;
+    while (true) {
+        if (out.empty()) {
+            // receiveBatch returns 0 only once the channel is closed and drained
+            StatsTimer timer(&ThreadStats::result_receive_wait);
+            if (resultChan->receiveBatch(slabs, PRINTER_BATCH_SIZE) == 0) {
+                break;
+            }
+        } else {
+            // Output is waiting, so do not block past its flush deadline
+            MatchSlab* first = nullptr;
+            bool received;
+            {
+                StatsTimer timer(&ThreadStats::result_receive_wait);
+                received = resultChan->receiveFor(first, out.timeUntilFlush());
+            }
+            if (!received) {
+                out.flush();
+                continue;
+            }
+            slabs.push_back(first);
+            while (slabs.size() < PRINTER_BATCH_SIZE) {
+                std::optional<MatchSlab*> next = resultChan->tryReceive();
+                if (!next) break;
+                slabs.push_back(*next);
+            }
+        }
+
+        if (order) {
+            // Print only what is next in traversal order; hold the rest
+            arrived.swap(slabs);
+            for (MatchSlab* slab : arrived) {
+                reorder.put(slab, slabs);
+            }
+            arrived.clear();
+        }
+
+        for (const MatchSlab* slab : slabs) {
+            if (slab->empty()) {
+                continue; // a sorted file without matches
+            }
+            if (manifest) {
+                manifest->record(*slab);
+            }
+            const std::string& file = slab->file_path.native();
+            if (settings.mode != reportMode::lines) {
+                if (stats) ++stats->matches_printed;
+                out.write(file);
+                if (settings.mode == reportMode::counts) {
+                    out.write(':');
+                    out.writeNumber(static_cast<long long>(slab->count));
+                }
+                out.write('\n');
+                continue;
+            }
+            if (stats) stats->matches_printed += slab->matches.size();
+            const std::string* threadName = nullptr;
+            if (settings.format == outputFormat::verbose) {
+                threadName = &threadIdText(threadNames, slab->thread_id);
+            }
+            for (const Match& m : slab->matches) {
+                printMatch(out, settings, file, threadName, slab->line(m), m);
+            }
+        }
+        matchSlabPool().release(slabs);
+        if (order) {
+            order->advance(reorder.next(), reorder.heldBytes() > REORDER_MAX_BYTES);
+        }
+        out.flushIfDue();
+    }
+    out.flush();
+}
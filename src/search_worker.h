@@ -12,7 +12,7 @@
  * processes file paths received from a channel, searches each file for a
  * specified target string, and sends any matches to a result channel. It also
  * includes the declaration of the printer thread function that receives
- * Match objects from the result channel and prints their details to the console.
+ * match slabs from the result channel and prints their details to the console.
  */
 
 #ifndef SEARCH_WORKER_H
@@ -21,79 +21,187 @@
 #include <string>
 #include <filesystem>
 #include <thread>
+#include <vector>
 #include "channel.h"
+#include "file_filter.h"
+#include "file_task.h"
+#include "manifest.h"
+#include "match.h"
+#include "matcher.h"
+#include "output_writer.h"
+#include "reorder.h"
+#include "thread_pool.h"
+
+// Number of file tasks a worker pulls from the file channel at once
+constexpr std::size_t WORKER_BATCH_SIZE = 32;
+
+// Number of match slabs (one per file) the printer pulls from the result channel at once
+constexpr std::size_t PRINTER_BATCH_SIZE = 64;
 
 /**
- * @struct Match
+ * @struct ScanLimits
  * 
- * @brief Structure to hold information about a search match
+ * @brief How much of each file the workers search and what they report
  * 
- * @var thread_id The ID of the thread that found the match
- * @var file_path The path of the file where the match was found
- * @var line_number The line number of the match in the file
- * @var line_content The content of the line containing the match
+ * @var mode Matching lines, or one summary per file
+ * @var max_count Matching lines to find per file before stopping (0 = no limit)
+ * @var search_binary Search files that look binary instead of skipping them
+ * @var skipped Counts the files skipped as binary, or nullptr
  * 
- * @details This structure contains the thread ID that found the match,
- * the file path where the match was found, the line number of the match,
- * and the content of the line containing the match.
+ * @details With reportMode::files a file is done at its first matching line.
+ * Otherwise the search stops after max_count matching lines, if set. Unless
+ * search_binary is set, a file whose first block looks binary is dropped
+ * before it is scanned.
+ */
+struct ScanLimits {
+    reportMode mode = reportMode::lines;
+    std::size_t max_count = 0;
+    bool search_binary = false;
+    SkipCounts* skipped = nullptr;
+};
+
+/**
+ * @struct PrinterSettings
+ * 
+ * @brief How the printer thread shows matches
+ * 
+ * @var format Verbose block or one compact line per match
+ * @var mode Matching lines, or per-file summaries printed as "path" (files)
+ *      or "path:count" (counts) whatever the format
+ * @var manifest Records every printed match for the next run, or nullptr
+ * @var patterns The patterns searched for; with more than one, each match also
+ *      shows the pattern it matched
+ * @var order With --sort, the window the producer numbers files through; the
+ *      printer then prints files in that order. nullptr prints in arrival order
  */
-struct Match {
-    std::thread::id thread_id;
-    std::filesystem::path file_path;
-    int line_number;
-    std::string line_content;
+struct PrinterSettings {
+    outputFormat format = outputFormat::verbose;
+    reportMode mode = reportMode::lines;
+    Manifest* manifest = nullptr;
+    std::vector<std::string> patterns;
+    ReorderWindow* order = nullptr;
 };
 
 /**
  * @brief Search a file for the target string and send matches to the result channel
  * 
  * @param filePath The path of the file to search
- * @param target The target string to search for
- * @param resultChan The channel to send Match objects through
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param limits When to stop searching and what to report
+ * @param resultChan The channel to send match slabs through
  * 
  * @return void
  * 
- * @details This function opens the specified file and reads it line by line.
- * For each line that contains the target string, it creates a Match object
- * and sends it through the provided result channel.
+ * @details This function loads the whole file (memory-mapped when possible)
+ * and searches its raw bytes for the target. Line numbers and line contents
+ * are only computed for hits. For each line that contains the target string,
+ * it records a Match in the thread's slab; the slab, holding all of the
+ * file's matches, is then sent through the provided result channel. When
+ * reporting files or counts only matching lines are counted and a summary
+ * slab is sent. The
+ * search ends early once the limits are reached, so the rest of a mapped
+ * file is never read.
  */
-static void searchFileForTarget(
+void searchFileForTarget(
     const std::filesystem::path& filePath,
-    const std::string& target,
-    channel<Match>* resultChan
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
+);
+
+/**
+ * @brief Search one file task, which is either a whole file or one chunk of a large file
+ * 
+ * @param task The task to search
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param limits When to stop searching and what to report
+ * @param resultChan The channel to send match slabs through
+ * 
+ * @return void
+ * 
+ * @details Whole-file tasks are searched in their contents when the read-ahead
+ * stage read them, and otherwise handed to searchFileForTarget. A chunk searches
+ * the lines that start inside its byte range and records its matches in the
+ * file's SplitFile; the worker that finishes the last chunk fixes up the line
+ * numbers and sends every match of the file, in file order, in one slab. The
+ * limits apply to the whole file, not to each chunk.
+ */
+void searchFileTask(
+    const FileTask& task,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
+);
+
+/**
+ * @brief Search one task, reporting rather than throwing any error
+ * 
+ * @param task The task to search
+ * @param matcher The matcher that locates the target in the file bytes
+ * @param limits When to stop searching and what to report
+ * @param resultChan The channel to send match slabs through
+ * 
+ * @return void
+ * 
+ * @details Runs searchFileTask. An error is printed on std::cerr; a chunk that
+ * failed still reports to its file so the other chunks' matches are sent, and
+ * a numbered file (--sort) that sent nothing sends an empty slab. This is
+ * what every thread that takes FileTasks runs for each of them.
+ */
+void runFileTask(
+    const FileTask& task,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    channel<MatchSlab*>* resultChan
 );
 
 /**
  * @brief Worker thread to process files from the file channel and search for the target string
  * 
- * @param fileChan The channel to receive file paths from
- * @param resultChan The channel to send Match objects through
- * @param target The target string to search for
+ * @param fileChan The channel to receive file tasks from
+ * @param resultChan The channel to send match slabs through
+ * @param matcher The matcher for the target string
+ * @param limits When to stop searching a file and what to report
+ * @param control The worker's handle on its ThreadPool, or nullptr
  * 
  * @return void
  * 
- * @details This function continuously receives file paths from the file channel,
- * searches each file for the target string using the searchFileForTarget helper,
- * and sends any matches to the result channel. It stops when the file channel is closed.
+ * @details This function continuously receives up to WORKER_BATCH_SIZE tasks at a
+ * time from the file channel, searches each file or chunk for the target string with
+ * runFileTask, and sends any matches to the result channel. It
+ * stops when the file channel is closed and drained, or earlier when an adaptive
+ * pool asks it to retire between batches. An error while searching one
+ * file is reported on std::cerr and the worker moves on to the next file.
  */
 void workerThreadFunc(
-    channel<std::filesystem::path>* fileChan,
-    channel<Match>* resultChan,
-    const std::string& target
+    channel<FileTask>* fileChan,
+    channel<MatchSlab*>* resultChan,
+    const Matcher& matcher,
+    const ScanLimits& limits,
+    PoolWorker* control = nullptr
 );
 
 /**
- * @brief Printer thread to receive Match objects from the result channel and print them
+ * @brief Printer thread to receive match slabs from the result channel and print them
  * 
- * @param resultChan The channel to receive Match objects from
+ * @param resultChan The channel to receive match slabs from
+ * @param settings Output format, manifest and pattern list
  * 
  * @return void
  * 
- * @details This function continuously receives Match objects from the result channel
- * and prints their details to the console. It stops when the result channel is closed.
+ * @details This function continuously receives batches of up to PRINTER_BATCH_SIZE
+ * match slabs from the result channel and prints their details to the console
+ * through a buffered OutputWriter, or one line per file when printing
+ * summaries, then returns the slabs to the pool. Buffered output is written when the buffer
+ * fills, when it has waited for the writer's flush delay, or when the result
+ * channel is closed and drained, at which point the function returns. With
+ * settings.order, slabs that arrive before their file's turn are held in a
+ * ReorderBuffer and printed as soon as every earlier file is done, and the
+ * window is advanced after each batch so the producer can move on.
  */
 void printerThreadFunc(
-    channel<Match>* resultChan
+    channel<MatchSlab*>* resultChan,
+    const PrinterSettings& settings
 );
 
 #endif // SEARCH_WORKER_H
\ No newline at end of file
@@ -0,0 +1,320 @@
+/**
+ * @file src/thread_pool.cpp
+ *
+ * @brief Implementation of the CPU topology, the worker pool and its resizing.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ */
+
+#include "thread_pool.h"
+#include <pthread.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+// Grow when more than this share of the time workers hold work is spent off the CPU
+constexpr double GROW_STALL_SHARE = 0.25;
+
+// Shrink when workers spend more than this share of their time waiting for work
+constexpr double SHRINK_WAIT_SHARE = 0.5;
+
+static std::int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Parse a sysfs CPU list such as "0-3,8-11"
+ */
+static std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream in(text);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        std::size_t dash = range.find('-');
+        int first = std::atoi(range.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+CpuTopology CpuTopology::detect() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    std::vector<int> usable;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) usable.push_back(cpu);
+        }
+    }
+
+    // Node directories are named node<N>; order them by N
+    std::map<int, std::vector<int>> byNode;
+    std::error_code ec;
+    std::filesystem::directory_iterator it("/sys/devices/system/node", ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        std::ifstream list(it->path() / "cpulist");
+        std::string text;
+        std::getline(list, text);
+        std::vector<int>& cpus = byNode[std::atoi(name.c_str() + 4)];
+        for (int cpu : parseCpuList(text)) {
+            if (std::find(usable.begin(), usable.end(), cpu) != usable.end()) cpus.push_back(cpu);
+        }
+    }
+
+    CpuTopology topology;
+    for (auto& node : byNode) {
+        if (!node.second.empty()) topology.nodes.push_back(std::move(node.second));
+    }
+    if (topology.nodes.empty()) {
+        topology.nodes.push_back(usable);
+    }
+    return topology;
+}
+
+std::size_t CpuTopology::cpuCount() const {
+    std::size_t count = 0;
+    for (const auto& node : nodes) {
+        count += node.size();
+    }
+    return count;
+}
+
+void PoolWorker::beginWait() {
+    if (!timed) return;
+    waitStarted.store(steadyNanos(), std::memory_order_relaxed);
+}
+
+void PoolWorker::endWait() {
+    if (!timed) return;
+    std::int64_t started = waitStarted.exchange(0, std::memory_order_relaxed);
+    if (started != 0) {
+        waited.fetch_add(steadyNanos() - started, std::memory_order_relaxed);
+    }
+}
+
+bool PoolWorker::retire() {
+    if (!timed || pool->surplus.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    // Leave at least one worker in the group, then claim one of the surplus
+    std::atomic<unsigned int>& active = pool->groups[groupIndex]->active;
+    unsigned int count = active.load();
+    if (count <= 1 || !active.compare_exchange_strong(count, count - 1)) {
+        return false;
+    }
+    unsigned int surplus = pool->surplus.load();
+    do {
+        if (surplus == 0) {
+            active.fetch_add(1);
+            return false;
+        }
+    } while (!pool->surplus.compare_exchange_weak(surplus, surplus - 1));
+    return true;
+}
+
+ThreadPool::ThreadPool(const CpuTopology& topology, const PoolSettings& poolSettings)
+    : settings(poolSettings) {
+    if (settings.threads == 0) settings.threads = 1;
+    if (settings.max_threads == 0) settings.max_threads = 4 * settings.threads;
+    if (settings.max_threads < settings.threads) settings.max_threads = settings.threads;
+
+    if (settings.numa) {
+        for (const auto& node : topology.nodes) {
+            groups.push_back(std::make_unique<Group>());
+            groups.back()->cpus = node;
+        }
+        // Every group needs a worker to drain its channel
+        if (groups.size() > settings.threads) groups.resize(settings.threads);
+    }
+    if (groups.empty()) {
+        groups.push_back(std::make_unique<Group>());
+        for (const auto& node : topology.nodes) {
+            groups.back()->cpus.insert(groups.back()->cpus.end(), node.begin(), node.end());
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+ThreadPool::Group* ThreadPool::smallestGroup() {
+    Group* smallest = groups.front().get();
+    for (const auto& group : groups) {
+        if (group->active.load() < smallest->active.load()) smallest = group.get();
+    }
+    return smallest;
+}
+
+/**
+ * @brief The CPUs a thread of a group runs on, if it is placed at all
+ *
+ * @param group The group
+ * @param single Pick the group's next CPU for a pinned worker rather than all of them
+ * @param cpus Set to the CPUs
+ *
+ * @return false when threads are left wherever the scheduler puts them
+ */
+bool ThreadPool::placement(const Group& group, bool single, cpu_set_t& cpus) const {
+    CPU_ZERO(&cpus);
+    if (group.cpus.empty() || !(settings.pin || settings.numa)) {
+        return false;
+    }
+    if (single) {
+        CPU_SET(group.cpus[group.started % group.cpus.size()], &cpus);
+    } else {
+        for (int cpu : group.cpus) CPU_SET(cpu, &cpus);
+    }
+    return true;
+}
+
+/**
+ * @brief Start one more worker in a group
+ *
+ * @details The worker sets its own affinity before running the body, so the
+ * memory it touches first is allocated on its node.
+ */
+void ThreadPool::launch(unsigned int groupIndex) {
+    Group& group = *groups[groupIndex];
+    cpu_set_t cpus;
+    bool place = placement(group, settings.pin, cpus);
+    ++group.started;
+    group.active.fetch_add(1);
+    live.fetch_add(1);
+
+    workers.push_back(std::make_unique<PoolWorker>());
+    PoolWorker* worker = workers.back().get();
+    worker->pool = this;
+    worker->workerIndex = static_cast<unsigned int>(workers.size() - 1);
+    worker->groupIndex = groupIndex;
+    worker->timed = settings.adaptive;
+
+    threads.emplace_back([this, worker, place, cpus] {
+        if (place) {
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+        body(*worker);
+        worker->running.store(false);
+        std::lock_guard<std::mutex> lk(mut);
+        live.fetch_sub(1);
+        done.notify_all();
+    });
+    if (settings.adaptive) {
+        worker->hasCpuClock = pthread_getcpuclockid(threads.back().native_handle(), &worker->cpuClock) == 0;
+    }
+}
+
+/**
+ * @brief Run a task on a thread placed like the group's workers and wait for it
+ *
+ * @details Memory the task allocates and touches first is then on the
+ * group's node rather than the caller's. That covers what a channel allocates
+ * when it is built, such as the lock-free channel's ring, but not what it
+ * allocates later from the threads that use it.
+ */
+void ThreadPool::runOnGroup(unsigned int groupIndex, const std::function<void()>& task) {
+    cpu_set_t cpus;
+    bool place = placement(*groups[groupIndex], false, cpus);
+    std::thread runner([&] {
+        if (place) {
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        }
+        task();
+    });
+    runner.join();
+}
+
+void ThreadPool::start(Body workerBody) {
+    body = std::move(workerBody);
+    for (unsigned int i = 0; i < settings.threads; ++i) {
+        launch(static_cast<unsigned int>(i % groups.size()));
+    }
+}
+
+void ThreadPool::join() {
+    if (settings.adaptive) {
+        std::unique_lock<std::mutex> lk(mut);
+        while (!done.wait_for(lk, ADAPT_INTERVAL, [this] { return live.load() == 0; })) {
+            lk.unlock();
+            adapt();
+            lk.lock();
+        }
+    }
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+/**
+ * @brief Sample the workers and grow or shrink the pool by one
+ *
+ * @details For each running worker the wall time since its last sample is
+ * split into time waiting for work (beginWait to endWait), time on the CPU
+ * (its thread CPU clock) and the rest, which is time spent stalled with work
+ * in hand: page faults on mapped files, opens and reads. Time blocked on a
+ * full result channel counts as waiting, since the printer is then the
+ * bottleneck and more workers would only queue behind it.
+ */
+void ThreadPool::adapt() {
+    const std::int64_t now = steadyNanos();
+    std::int64_t wall = 0, waiting = 0, running = 0, stalled = 0;
+    for (const auto& worker : workers) {
+        if (!worker->running.load() || !worker->hasCpuClock) continue;
+        timespec cpuTime;
+        if (clock_gettime(worker->cpuClock, &cpuTime) != 0) continue;
+        const std::int64_t cpu = std::int64_t(cpuTime.tv_sec) * 1000000000 + cpuTime.tv_nsec;
+        std::int64_t waited = worker->waited.load(std::memory_order_relaxed);
+        std::int64_t started = worker->waitStarted.load(std::memory_order_relaxed);
+        if (started != 0 && started < now) waited += now - started;
+
+        Sample& last = samples[worker.get()];
+        if (last.at == 0) last.at = now - ADAPT_INTERVAL.count() * 1000000;
+        const std::int64_t span = now - last.at;
+        const std::int64_t waitSpan = std::clamp<std::int64_t>(waited - last.waited, 0, span);
+        const std::int64_t runSpan = span - waitSpan;
+        wall += span;
+        waiting += waitSpan;
+        running += runSpan;
+        stalled += std::clamp<std::int64_t>(runSpan - (cpu - last.cpu), 0, runSpan);
+        last = Sample{now, cpu, waited};
+    }
+    if (wall == 0) return;
+
+    unsigned int active = 0;
+    for (const auto& group : groups) {
+        active += group->active.load();
+    }
+    const unsigned int pendingRetire = surplus.load();
+    const unsigned int target = active > pendingRetire ? active - pendingRetire : 0;
+    if (double(waiting) > SHRINK_WAIT_SHARE * double(wall)) {
+        if (target > groups.size()) surplus.fetch_add(1);
+    } else if (running > 0 && double(stalled) > GROW_STALL_SHARE * double(running)) {
+        unsigned int pending = pendingRetire;
+        if (pending > 0 && surplus.compare_exchange_strong(pending, pending - 1)) {
+            // Cancelled a retirement that had not happened yet
+        } else if (active < settings.max_threads) {
+            Group* smallest = smallestGroup();
+            for (unsigned int i = 0; i < groups.size(); ++i) {
+                if (groups[i].get() == smallest) launch(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,221 @@
+/**
+ * @file src/thread_pool.h
+ *
+ * @brief Declaration of the worker pool, with CPU pinning, NUMA groups and adaptive sizing.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declarations of CpuTopology, which reads the NUMA
+ * nodes and usable CPUs of the machine from sysfs, PoolSettings, ThreadPool,
+ * which runs a number of copies of one worker body, and PoolWorker, each
+ * copy's handle on the pool. The pool can pin each worker to one CPU, split
+ * its workers into one group per NUMA node confined to that node's CPUs (the
+ * caller gives each group its own channel, created on the node), and grow or shrink itself while
+ * it runs from how much of their time the workers spend off the CPU with
+ * work in hand, compared with time spent waiting for work. fanOut() deals
+ * one channel out to the groups' channels.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <sched.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "channel.h"
+
+// How often an adaptive pool samples its workers and may resize
+constexpr std::chrono::milliseconds ADAPT_INTERVAL{100};
+
+/**
+ * @struct CpuTopology
+ *
+ * @brief The CPUs this process may run on, grouped by NUMA node
+ *
+ * @var nodes The usable CPU numbers of each node that has any
+ *
+ * @details detect() reads /sys/devices/system/node and keeps only the CPUs in
+ * the process's affinity mask. Without NUMA information every usable CPU is
+ * put in one node.
+ */
+struct CpuTopology {
+    std::vector<std::vector<int>> nodes;
+
+    static CpuTopology detect();
+    std::size_t cpuCount() const;
+};
+
+/**
+ * @struct PoolSettings
+ *
+ * @brief How a ThreadPool is sized and placed
+ *
+ * @var threads Workers to start with
+ * @var max_threads Most workers an adaptive pool grows to (0 = 4 x threads)
+ * @var pin Pin each worker to a single CPU, spread round-robin over its group
+ * @var numa One worker group per NUMA node, each confined to its node's CPUs
+ * @var adaptive Grow or shrink the pool while it runs
+ */
+struct PoolSettings {
+    unsigned int threads = 1;
+    unsigned int max_threads = 0;
+    bool pin = false;
+    bool numa = false;
+    bool adaptive = false;
+};
+
+class ThreadPool;
+
+/**
+ * @class PoolWorker
+ *
+ * @brief One worker's handle on its pool
+ *
+ * @details A worker body brackets every blocking receive of new work, and
+ * every blocking send of results, with beginWait() and endWait(), which only
+ * read the clock in an adaptive pool, and calls retire() between units of work: when it returns true the pool is
+ * shrinking and the body should return. The last worker of a group never
+ * retires, so a group's channel is always drained.
+ */
+class PoolWorker {
+public:
+    unsigned int index() const { return workerIndex; }
+    unsigned int group() const { return groupIndex; }
+
+    void beginWait();
+    void endWait();
+    bool retire();
+
+private:
+    friend class ThreadPool;
+
+    ThreadPool* pool = nullptr;
+    unsigned int workerIndex = 0;
+    unsigned int groupIndex = 0;
+    bool timed = false;
+    std::atomic<std::int64_t> waitStarted{0};
+    std::atomic<std::int64_t> waited{0};
+    std::atomic<bool> running{true};
+    clockid_t cpuClock = 0;
+    bool hasCpuClock = false;
+};
+
+/**
+ * @class ThreadPool
+ *
+ * @brief Runs copies of one worker body across groups of CPUs
+ *
+ * @details start() launches settings.threads workers, spread evenly over the
+ * groups. join() returns once every worker has returned; in an adaptive pool
+ * the calling thread samples the workers every ADAPT_INTERVAL meanwhile and
+ * adds a worker to the smallest group when they are mostly stalled off the
+ * CPU with work in hand (page faults, opens and reads), or asks one to retire
+ * when they mostly wait for work or for room to send results. runOnGroup()
+ * lets the caller allocate a group's channel from that group's CPUs.
+ */
+class ThreadPool {
+public:
+    using Body = std::function<void(PoolWorker&)>;
+
+    ThreadPool(const CpuTopology& topology, const PoolSettings& settings);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t groupCount() const { return groups.size(); }
+    unsigned int peakThreads() const { return static_cast<unsigned int>(workers.size()); }
+
+    void start(Body workerBody);
+    void join();
+    void runOnGroup(unsigned int group, const std::function<void()>& task);
+
+private:
+    friend class PoolWorker;
+
+    struct Group {
+        std::vector<int> cpus;
+        std::atomic<unsigned int> active{0};
+        unsigned int started = 0;
+    };
+
+    // A worker's clocks when it was last sampled
+    struct Sample {
+        std::int64_t at = 0;
+        std::int64_t cpu = 0;
+        std::int64_t waited = 0;
+    };
+
+    bool placement(const Group& group, bool single, cpu_set_t& cpus) const;
+    void launch(unsigned int group);
+    void adapt();
+    Group* smallestGroup();
+
+    PoolSettings settings;
+    Body body;
+    std::vector<std::unique_ptr<Group>> groups;
+    std::vector<std::unique_ptr<PoolWorker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned int> surplus{0};
+    std::atomic<unsigned int> live{0};
+    std::mutex mut;
+    std::condition_variable done;
+    std::unordered_map<const PoolWorker*, Sample> samples;
+};
+
+// Items fanOut() moves to one group's channel at a time
+constexpr std::size_t FAN_OUT_BATCH = 16;
+
+/**
+ * @brief Deal the items of one channel out to several, a batch at a time
+ *
+ * @param in The channel to drain
+ * @param outs The channels to fill in turn; each is closed once in is closed and drained
+ *
+ * @return void
+ *
+ * @details Used to give each worker group its own channel. Items go out in
+ * batches of up to FAN_OUT_BATCH so the groups' channels see few handoffs.
+ * Each batch goes to the next channel in turn that has room, without
+ * blocking, and what does not fit moves on to the channel after it; so a
+ * group whose workers are stuck on slow files is skipped rather than holding
+ * up the others. Only when every channel is full does fanOut() block, on one
+ * item.
+ */
+template <class X>
+void fanOut(channel<X>* in, std::vector<channel<X>*> outs) {
+    std::vector<X> batch;
+    std::size_t next = 0;
+    while (in->receiveBatch(batch, FAN_OUT_BATCH) > 0) {
+        std::size_t full = 0;
+        while (!batch.empty()) {
+            channel<X>* out = outs[next];
+            next = (next + 1) % outs.size();
+            if (out->trySendBatch(batch) > 0) {
+                full = 0;
+            } else if (++full == outs.size()) {
+                // Every group has work queued, so waiting for room in one starves none
+                out->send(std::move(batch.front()));
+                batch.erase(batch.begin());
+                full = 0;
+            }
+        }
+    }
+    for (channel<X>* out : outs) {
+        out->close();
+    }
+}
+
+#endif // THREAD_POOL_H
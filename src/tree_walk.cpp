@@ -0,0 +1,46 @@
+/**
+ * @file src/tree_walk.cpp
+ *
+ * @brief Implementation of the directory listing shared by the work-stealing walks.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ */
+
+#include "tree_walk.h"
+#include <iostream>
+
+void listWalkDirectory(
+    const WalkRules& rules,
+    const FileFilter* filter,
+    const std::filesystem::path& dir,
+    const WalkRules::Scope& parentScope,
+    const std::function<void(const std::filesystem::path&, const WalkRules::Scope&)>& onDirectory,
+    const std::function<void(const std::filesystem::directory_entry&)>& onFile
+) {
+    WalkRules::Scope scope = rules.enter(parentScope, dir);
+    ThreadStats* stats = threadStats();
+    std::error_code ec;
+    std::filesystem::directory_iterator it(dir, ec);
+    const std::filesystem::directory_iterator end;
+    for (; !ec && it != end; it.increment(ec)) {
+        const std::filesystem::directory_entry& entry = *it;
+        std::error_code statEc;
+        if (entry.is_directory(statEc) && !entry.is_symlink(statEc)) {
+            if (rules.walkDirectory(scope, entry)) {
+                onDirectory(entry.path(), scope);
+            }
+        } else if (entry.is_regular_file(statEc)) {
+            if (stats) ++stats->files_walked;
+            if (!rules.searchFile(scope, entry) || (filter && !filter->mustSearch(entry))) {
+                continue;
+            }
+            if (stats) ++stats->files_sent;
+            onFile(entry);
+        }
+    }
+    if (ec) {
+        std::cerr << "Error during directory traversal: " << dir.string()
+                  << ": " << ec.message() << std::endl;
+    }
+}
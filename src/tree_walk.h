@@ -0,0 +1,139 @@
+/**
+ * @file src/tree_walk.h
+ *
+ * @brief Declaration of the work-stealing tree walk shared by the parallel
+ *        walker and the fused engine.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains listWalkDirectory, which lists one directory against the
+ * walk rules and the file filter, and TreeWalk, the per-thread deques, the
+ * count of unfinished tasks and the steal-and-back-off loop that the parallel
+ * walker (directories only) and the fused engine (directories and files) run
+ * their threads on. The callers only decide what a task is and what to do
+ * with each subdirectory and file a listing finds.
+ */
+
+#ifndef TREE_WALK_H
+#define TREE_WALK_H
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "file_filter.h"
+#include "search_stats.h"
+#include "walk_rules.h"
+#include "work_deque.h"
+
+/**
+ * @brief List one directory of a walk
+ *
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Rules out files that need not be searched, or nullptr
+ * @param dir The directory to list
+ * @param parentScope The .gitignore scope of its parent; dir's own .gitignore is read here
+ * @param onDirectory Called with each subdirectory to walk and the scope it is listed in
+ * @param onFile Called with each regular file to search
+ *
+ * @return void
+ *
+ * @details Symlinked directories are not followed, matching the default
+ * behaviour of recursive_directory_iterator. Every regular file counts as
+ * walked and every file passed to onFile as sent in the calling thread's
+ * stats. A directory that cannot be read is reported on std::cerr and
+ * skipped; the rest of the walk goes on.
+ */
+void listWalkDirectory(
+    const WalkRules& rules,
+    const FileFilter* filter,
+    const std::filesystem::path& dir,
+    const WalkRules::Scope& parentScope,
+    const std::function<void(const std::filesystem::path&, const WalkRules::Scope&)>& onDirectory,
+    const std::function<void(const std::filesystem::directory_entry&)>& onFile
+);
+
+/**
+ * @class TreeWalk
+ *
+ * @brief Tasks shared by a fixed set of threads through work-stealing deques
+ *
+ * @details Each thread pushes the tasks it creates onto its own deque and
+ * run() pops from it, stealing the oldest task of another thread when its own
+ * runs dry. A task is counted before it is pushed and uncounted only after it
+ * has been handled, and handling may push more, so the count reaching zero
+ * means the whole tree is done. handle() must not throw.
+ */
+template <class Task>
+class TreeWalk {
+public:
+    explicit TreeWalk(unsigned int threads) : deques(threads == 0 ? 1 : threads) {}
+
+    unsigned int threads() const { return static_cast<unsigned int>(deques.size()); }
+
+    void push(unsigned int self, Task task) {
+        pending.fetch_add(1);
+        deques[self].push(std::move(task));
+    }
+
+    /**
+     * @brief Body of one walking thread
+     *
+     * @param self Index of the calling thread
+     * @param handle Called with each task the thread takes
+     * @param idle Called whenever no task is found anywhere, before backing off
+     *
+     * @details An idle thread backs off, yielding for the first rounds and
+     * then sleeping, until either work shows up or nothing is pending.
+     */
+    template <class Handle, class Idle>
+    void run(unsigned int self, Handle handle, Idle idle) {
+        Task task;
+        unsigned int idleRounds = 0;
+        while (true) {
+            if (find(self, task)) {
+                idleRounds = 0;
+                handle(task);
+                pending.fetch_sub(1);
+                continue;
+            }
+
+            idle();
+            if (pending.load() == 0) {
+                break;
+            }
+            StatsTimer timer(&ThreadStats::steal_wait);
+            if (++idleRounds < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+private:
+    // The thread's own deque first, then the others starting with the next so thieves spread out
+    bool find(unsigned int self, Task& task) {
+        if (deques[self].pop(task)) {
+            return true;
+        }
+        const unsigned int n = threads();
+        for (unsigned int k = 1; k < n; ++k) {
+            if (deques[(self + k) % n].steal(task)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<workStealingDeque<Task>> deques;
+    std::atomic<long> pending{0};
+};
+
+#endif // TREE_WALK_H
@@ -0,0 +1,510 @@
+/**
+ * @file src/trigram_index.cpp
+ *
+ * @brief Implementation of building, opening and querying the trigram index.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of the trigram index. Building
+ * walks the tree once, then a pool of threads reads the files and collects
+ * each file's distinct trigrams. The (trigram, file id) pairs are sorted
+ * into posting lists and the whole index is laid out in one buffer that is
+ * written with a single write. Querying decodes the posting lists of the
+ * target's trigrams and intersects them.
+ */
+
+#include "trigram_index.h"
+#include "producer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace {
+
+const char INDEX_MAGIC[8] = {'S', 'R', 'C', 'H', 'I', 'D', 'X', '\0'};
+const std::uint32_t INDEX_VERSION = 1;
+
+// Every table starts on an 8-byte boundary so entries can be read in place
+struct IndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t file_count;
+    std::uint64_t trigram_count;
+    std::uint64_t files_offset;
+    std::uint64_t trigrams_offset;
+    std::uint64_t postings_offset;
+    std::uint64_t postings_size;
+    std::uint64_t paths_offset;
+    std::uint64_t paths_size;
+};
+
+struct IndexFileEntry {
+    std::uint64_t path_offset;  // into the path bytes
+    std::uint32_t path_length;
+    std::uint32_t reserved;
+    std::uint64_t size;
+    std::int64_t mtime;
+};
+
+struct IndexTrigramEntry {
+    std::uint32_t trigram;
+    std::uint32_t count;        // file ids in the posting list
+    std::uint64_t offset;       // into the postings
+    std::uint64_t length;       // encoded bytes
+};
+
+// Trigrams are 24-bit values, one byte per character
+const std::uint32_t TRIGRAM_SPACE = 1u << 24;
+
+/**
+ * @brief ASCII case folding so one index serves exact and case-insensitive searches
+ */
+inline unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+inline std::uint32_t trigramAt(const unsigned char* p) {
+    return (std::uint32_t(fold(p[0])) << 16) | (std::uint32_t(fold(p[1])) << 8) | fold(p[2]);
+}
+
+// Bytes of a file whose trigrams are collected under one SIGBUS guard
+const std::size_t TRIGRAM_WINDOW = 64 << 10;
+
+/**
+ * @brief Collect the distinct trigrams of a file
+ *
+ * @param file The file's bytes
+ * @param seen A TRIGRAM_SPACE-bit scratch bitmap, all clear on entry and on return
+ * @param out Set to the distinct trigrams, sorted
+ *
+ * @return false, with out empty, if the file shrank under its mapping
+ *
+ * @details The bytes are read TRIGRAM_WINDOW at a time with FileBuffer::read().
+ * Before each window out is grown to hold every trigram the window could
+ * add, so the guarded loop only loads bytes and stores into memory that
+ * already exists. After a fault the bitmap is cleared in full, since the
+ * count of trigrams stored may not have reached memory.
+ */
+bool distinctTrigrams(const FileBuffer& file, std::vector<std::uint64_t>& seen, std::vector<std::uint32_t>& out) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(file.data());
+    const std::size_t n = file.size();
+    std::size_t count = 0;
+    bool readable = true;
+    for (std::size_t from = 0; readable && from + 3 <= n; from += TRIGRAM_WINDOW) {
+        // Trigrams starting in [from, to)
+        const std::size_t to = std::min(n - 2, from + TRIGRAM_WINDOW);
+        if (out.size() < count + (to - from)) {
+            out.resize(count + (to - from));
+        }
+        std::uint64_t* bits = seen.data();
+        std::uint32_t* found = out.data();
+        readable = file.read([&] {
+            for (std::size_t i = from; i < to; ++i) {
+                std::uint32_t t = trigramAt(p + i);
+                std::uint64_t bit = std::uint64_t(1) << (t & 63);
+                if (!(bits[t >> 6] & bit)) {
+                    bits[t >> 6] |= bit;
+                    found[count++] = t;
+                }
+            }
+        });
+    }
+    if (!readable) {
+        std::fill(seen.begin(), seen.end(), 0);
+        out.clear();
+        return false;
+    }
+    out.resize(count);
+    for (std::uint32_t t : out) {
+        seen[t >> 6] = 0;
+    }
+    std::sort(out.begin(), out.end());
+    return true;
+}
+
+void putVarint(std::vector<char>& out, std::uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+template <class T>
+void putRaw(std::vector<char>& out, std::size_t at, const T& value) {
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+std::size_t alignUp(std::size_t n) {
+    return (n + 7) & ~std::size_t(7);
+}
+
+struct IndexedFile {
+    std::filesystem::path path;
+    std::string key;
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;
+    bool read = false;
+    std::vector<std::uint32_t> trigrams;
+};
+
+} // namespace
+
+std::string indexRootPrefix(const std::filesystem::path& rootDir) {
+    std::string prefix = rootDir.native();
+    if (!prefix.empty() && prefix.back() != '/') {
+        prefix += '/';
+    }
+    return prefix;
+}
+
+std::string indexKey(const std::string& rootPrefix, const std::filesystem::path& p) {
+    const std::string& full = p.native();
+    if (full.compare(0, rootPrefix.size(), rootPrefix) == 0) {
+        return full.substr(rootPrefix.size());
+    }
+    return full;
+}
+
+std::int64_t indexMtime(std::filesystem::file_time_type t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+long long buildTrigramIndex(
+    const std::filesystem::path& rootDir,
+    const std::filesystem::path& indexPath,
+    unsigned int threads
+) {
+    if (threads == 0) threads = 1;
+
+    // Walk first; size and mtime are taken before the file is read so an
+    // edit during indexing makes the entry look stale rather than current
+    const std::string rootPrefix = indexRootPrefix(rootDir);
+    std::vector<IndexedFile> files;
+    try {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(rootDir)) {
+            std::error_code ec;
+            if (!entry.is_regular_file(ec) || !hasValidExtension(entry.path())) continue;
+            IndexedFile file;
+            file.path = entry.path();
+            file.key = indexKey(rootPrefix, file.path);
+            file.size = entry.file_size(ec);
+            if (ec) continue;
+            file.mtime = indexMtime(entry.last_write_time(ec));
+            if (ec) continue;
+            files.push_back(std::move(file));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error during directory traversal: " << e.what() << std::endl;
+    }
+
+    // Read the files in parallel, each thread with its own scratch bitmap
+    std::atomic<std::size_t> next{0};
+    auto readFiles = [&]() {
+        std::vector<std::uint64_t> seen(TRIGRAM_SPACE / 64, 0);
+        std::size_t i;
+        while ((i = next.fetch_add(1)) < files.size()) {
+            FileBuffer buffer(files[i].path);
+            if (!buffer.isOpen()) continue; // left out of the index, so always searched
+            // A file truncated while mapped is left out too
+            files[i].read = distinctTrigrams(buffer, seen, files[i].trigrams);
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned int t = 0; t < threads; ++t) {
+        pool.emplace_back(readFiles);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    // Unreadable files get no id
+    std::vector<IndexedFile*> kept;
+    std::size_t pairCount = 0;
+    for (IndexedFile& file : files) {
+        if (file.read) {
+            kept.push_back(&file);
+            pairCount += file.trigrams.size();
+        }
+    }
+
+    // (trigram << 32 | id) sorts into posting lists with ascending ids
+    std::vector<std::uint64_t> pairs;
+    pairs.reserve(pairCount);
+    for (std::uint32_t id = 0; id < kept.size(); ++id) {
+        for (std::uint32_t t : kept[id]->trigrams) {
+            pairs.push_back((std::uint64_t(t) << 32) | id);
+        }
+        std::vector<std::uint32_t>().swap(kept[id]->trigrams);
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    std::vector<IndexTrigramEntry> trigramTable;
+    std::vector<char> postings;
+    for (std::size_t i = 0; i < pairs.size();) {
+        IndexTrigramEntry entry{};
+        entry.trigram = static_cast<std::uint32_t>(pairs[i] >> 32);
+        entry.offset = postings.size();
+        std::uint32_t prev = 0;
+        for (; i < pairs.size() && static_cast<std::uint32_t>(pairs[i] >> 32) == entry.trigram; ++i) {
+            std::uint32_t id = static_cast<std::uint32_t>(pairs[i]);
+            putVarint(postings, id - prev);
+            prev = id;
+            ++entry.count;
+        }
+        entry.length = postings.size() - entry.offset;
+        trigramTable.push_back(entry);
+    }
+    std::vector<std::uint64_t>().swap(pairs);
+
+    // Lay out the whole file
+    std::size_t pathBytes = 0;
+    for (const IndexedFile* file : kept) pathBytes += file->key.size();
+
+    IndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.file_count = kept.size();
+    header.trigram_count = trigramTable.size();
+    header.files_offset = alignUp(sizeof(IndexHeader));
+    header.trigrams_offset = alignUp(header.files_offset + kept.size() * sizeof(IndexFileEntry));
+    header.postings_offset = alignUp(header.trigrams_offset + trigramTable.size() * sizeof(IndexTrigramEntry));
+    header.postings_size = postings.size();
+    header.paths_offset = alignUp(header.postings_offset + postings.size());
+    header.paths_size = pathBytes;
+
+    std::vector<char> out(header.paths_offset + pathBytes, 0);
+    putRaw(out, 0, header);
+    std::uint64_t pathAt = 0;
+    for (std::size_t id = 0; id < kept.size(); ++id) {
+        IndexFileEntry entry{};
+        entry.path_offset = pathAt;
+        entry.path_length = static_cast<std::uint32_t>(kept[id]->key.size());
+        entry.size = kept[id]->size;
+        entry.mtime = kept[id]->mtime;
+        putRaw(out, header.files_offset + id * sizeof(IndexFileEntry), entry);
+        std::memcpy(out.data() + header.paths_offset + pathAt, kept[id]->key.data(), kept[id]->key.size());
+        pathAt += kept[id]->key.size();
+    }
+    if (!trigramTable.empty()) {
+        std::memcpy(out.data() + header.trigrams_offset, trigramTable.data(),
+                    trigramTable.size() * sizeof(IndexTrigramEntry));
+    }
+    if (!postings.empty()) {
+        std::memcpy(out.data() + header.postings_offset, postings.data(), postings.size());
+    }
+
+    // Write beside the target and rename so readers never see a partial index
+    std::filesystem::path tmpPath = indexPath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(out.data(), static_cast<std::streamsize>(out.size()));
+        if (!file) {
+            std::cerr << "Error writing index " << tmpPath.string() << std::endl;
+            return -1;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, indexPath, ec);
+    if (ec) {
+        std::cerr << "Error writing index " << indexPath.string() << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return -1;
+    }
+    return static_cast<long long>(kept.size());
+}
+
+bool TrigramIndex::open(const std::filesystem::path& indexPath, std::string& error) {
+    buffer.emplace(indexPath);
+    if (!buffer->isOpen()) {
+        error = "cannot be read";
+        return false;
+    }
+    const std::size_t size = buffer->size();
+    base = buffer->data();
+
+    IndexHeader header;
+    if (size < sizeof(IndexHeader)) {
+        error = "too short";
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(IndexHeader));
+    if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION) {
+        error = "not an index file or from another version";
+        return false;
+    }
+
+    // Every table must lie inside the file and be aligned for in-place reads
+    auto fits = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t width) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / width;
+    };
+    if (!fits(header.files_offset, header.file_count, sizeof(IndexFileEntry))
+        || !fits(header.trigrams_offset, header.trigram_count, sizeof(IndexTrigramEntry))
+        || !fits(header.postings_offset, header.postings_size, 1)
+        || !fits(header.paths_offset, header.paths_size, 1)
+        || header.file_count > UINT32_MAX) {
+        error = "truncated or corrupt";
+        return false;
+    }
+    const IndexFileEntry* fileTable = reinterpret_cast<const IndexFileEntry*>(base + header.files_offset);
+    for (std::uint64_t i = 0; i < header.file_count; ++i) {
+        if (fileTable[i].path_offset > header.paths_size
+            || fileTable[i].path_length > header.paths_size - fileTable[i].path_offset) {
+            error = "truncated or corrupt";
+            return false;
+        }
+    }
+    const IndexTrigramEntry* trigramTable = reinterpret_cast<const IndexTrigramEntry*>(base + header.trigrams_offset);
+    for (std::uint64_t i = 0; i < header.trigram_count; ++i) {
+        if (trigramTable[i].offset > header.postings_size
+            || trigramTable[i].length > header.postings_size - trigramTable[i].offset
+            || (i > 0 && trigramTable[i].trigram <= trigramTable[i - 1].trigram)) {
+            error = "truncated or corrupt";
+            return false;
+        }
+    }
+
+    files = static_cast<std::size_t>(header.file_count);
+    trigrams = static_cast<std::size_t>(header.trigram_count);
+    return true;
+}
+
+std::size_t TrigramIndex::fileCount() const {
+    return files;
+}
+
+static const IndexHeader& headerOf(const char* base) {
+    return *reinterpret_cast<const IndexHeader*>(base);
+}
+
+static const IndexFileEntry& fileEntry(const char* base, std::size_t id) {
+    return reinterpret_cast<const IndexFileEntry*>(base + headerOf(base).files_offset)[id];
+}
+
+std::string TrigramIndex::filePath(std::size_t id) const {
+    const IndexFileEntry& entry = fileEntry(base, id);
+    const char* paths = base + headerOf(base).paths_offset;
+    return std::string(paths + entry.path_offset, entry.path_length);
+}
+
+std::uint64_t TrigramIndex::fileSize(std::size_t id) const {
+    return fileEntry(base, id).size;
+}
+
+std::int64_t TrigramIndex::fileMtime(std::size_t id) const {
+    return fileEntry(base, id).mtime;
+}
+
+/**
+ * @brief Decode the posting list of one trigram
+ *
+ * @return false if no indexed file contains the trigram
+ */
+bool TrigramIndex::postings(std::uint32_t trigram, std::vector<std::uint32_t>& ids) const {
+    ids.clear();
+    const IndexTrigramEntry* table = reinterpret_cast<const IndexTrigramEntry*>(base + headerOf(base).trigrams_offset);
+    const IndexTrigramEntry* end = table + trigrams;
+    const IndexTrigramEntry* it = std::lower_bound(table, end, trigram,
+        [](const IndexTrigramEntry& e, std::uint32_t t) { return e.trigram < t; });
+    if (it == end || it->trigram != trigram) {
+        return false;
+    }
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(base + headerOf(base).postings_offset + it->offset);
+    const unsigned char* stop = p + it->length;
+    ids.reserve(it->count);
+    std::uint32_t id = 0;
+    while (p < stop) {
+        std::uint32_t delta = 0;
+        int shift = 0;
+        while (p < stop && (*p & 0x80) && shift < 28) {
+            delta |= std::uint32_t(*p++ & 0x7f) << shift;
+            shift += 7;
+        }
+        if (p == stop) break; // corrupt tail; whatever decoded so far is kept
+        delta |= std::uint32_t(*p++) << shift;
+        id += delta;
+        if (id >= files) break;
+        ids.push_back(id);
+    }
+    return true;
+}
+
+bool TrigramIndex::candidates(const std::string& target, std::vector<char>& candidate) const {
+    candidate.assign(files, 1);
+    if (target.size() < 3) {
+        return false;
+    }
+
+    std::vector<std::uint32_t> wanted;
+    for (std::size_t i = 0; i + 3 <= target.size(); ++i) {
+        wanted.push_back(trigramAt(reinterpret_cast<const unsigned char*>(target.data()) + i));
+    }
+    std::sort(wanted.begin(), wanted.end());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
+    std::vector<std::uint32_t> ids;
+    std::vector<char> hit(files, 0);
+    for (std::uint32_t t : wanted) {
+        if (!postings(t, ids)) {
+            candidate.assign(files, 0);
+            return true;
+        }
+        for (std::uint32_t id : ids) hit[id] = 1;
+        for (std::size_t id = 0; id < files; ++id) {
+            candidate[id] &= hit[id];
+        }
+        for (std::uint32_t id : ids) hit[id] = 0;
+    }
+    return true;
+}
+
+IndexQuery::IndexQuery(const TrigramIndex& index, const std::filesystem::path& rootDir, const std::vector<std::string>& patterns)
+    : index(index), rootPrefix(indexRootPrefix(rootDir)) {
+    // A file is a candidate if it may contain any of the patterns
+    candidate.assign(index.fileCount(), 0);
+    std::vector<char> perPattern;
+    for (const std::string& pattern : patterns) {
+        if (!index.candidates(pattern, perPattern)) {
+            return; // a pattern too short to narrow: nothing can be ruled out
+        }
+        for (std::size_t id = 0; id < perPattern.size(); ++id) {
+            candidate[id] |= perPattern[id];
+        }
+    }
+    narrowing = true;
+    ids.reserve(index.fileCount());
+    for (std::size_t id = 0; id < index.fileCount(); ++id) {
+        ids.emplace(index.filePath(id), static_cast<std::uint32_t>(id));
+        if (!candidate[id]) ++skippable;
+    }
+}
+
+bool IndexQuery::mustSearch(const std::filesystem::directory_entry& entry) const {
+    if (!narrowing) {
+        return true;
+    }
+    auto it = ids.find(indexKey(rootPrefix, entry.path()));
+    if (it == ids.end() || candidate[it->second]) {
+        return true;
+    }
+    // Only trust the index for files that have not changed since it was built
+    std::error_code ec;
+    std::uintmax_t size = entry.file_size(ec);
+    if (ec || size != index.fileSize(it->second)) {
+        return true;
+    }
+    std::filesystem::file_time_type mtime = entry.last_write_time(ec);
+    return ec || indexMtime(mtime) != index.fileMtime(it->second);
+}
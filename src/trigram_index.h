@@ -0,0 +1,165 @@
+/**
+ * @file src/trigram_index.h
+ *
+ * @brief Declaration of the persistent trigram index used to skip files
+ *        that cannot contain the target.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declarations for building, opening and querying
+ * an on-disk trigram index. For every indexed file the index records its
+ * size and modification time and the set of 3-byte sequences (trigrams) it
+ * contains, case-folded for ASCII. A file can only contain the target if it
+ * contains every trigram of the target, so a query narrows the search to the
+ * files whose posting lists all include it. Files that are missing from the
+ * index or that changed since it was built are always searched, so a stale
+ * index only costs speed, never results.
+ *
+ * On-disk layout (native byte order, all offsets from the start of the file):
+ *
+ *   IndexHeader
+ *   IndexFileEntry[file_count]        a file's id is its position here
+ *   IndexTrigramEntry[trigram_count]  sorted by trigram for binary search
+ *   postings                          per trigram, ascending file ids as
+ *                                     varint-encoded deltas
+ *   path bytes                        root-relative paths, not null terminated
+ *
+ * The file is opened with FileBuffer, so it is memory-mapped and only the
+ * pages a query touches are read.
+ */
+
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "file_buffer.h"
+
+// Default index file name, stored in the root of the indexed tree
+constexpr const char* DEFAULT_INDEX_NAME = ".search-index";
+
+/**
+ * @brief Build the index for a directory tree and write it to indexPath
+ *
+ * @param rootDir The root of the tree to index
+ * @param indexPath Where to write the index
+ * @param threads Number of threads reading files
+ *
+ * @return Number of files indexed, or -1 if the index could not be written
+ *
+ * @details The same files the search would visit (regular files with a valid
+ * extension, symlinked directories not followed) are indexed. The index is
+ * written to a temporary file next to indexPath and renamed into place, so a
+ * concurrent search sees either the old index or the new one.
+ */
+long long buildTrigramIndex(
+    const std::filesystem::path& rootDir,
+    const std::filesystem::path& indexPath,
+    unsigned int threads
+);
+
+/**
+ * @class TrigramIndex
+ *
+ * @brief A read-only, memory-mapped trigram index
+ *
+ * @details open() validates the header and every table bound once, so the
+ * lookups afterwards need no checks beyond the posting decoder's own.
+ */
+class TrigramIndex {
+public:
+    /**
+     * @brief Map and validate an index file
+     *
+     * @param indexPath The index file
+     * @param error Set to the reason when false is returned
+     *
+     * @return true if the index is usable
+     */
+    bool open(const std::filesystem::path& indexPath, std::string& error);
+
+    std::size_t fileCount() const;
+
+    /**
+     * @brief Mark the files that contain every trigram of target
+     *
+     * @param target The search text
+     * @param candidate Resized to fileCount(); candidate[id] is set for files
+     *        that may contain target
+     *
+     * @return false if target is shorter than a trigram and nothing can be ruled out
+     */
+    bool candidates(const std::string& target, std::vector<char>& candidate) const;
+
+    std::string filePath(std::size_t id) const;
+    std::uint64_t fileSize(std::size_t id) const;
+    std::int64_t fileMtime(std::size_t id) const;
+
+private:
+    bool postings(std::uint32_t trigram, std::vector<std::uint32_t>& ids) const;
+
+    std::optional<FileBuffer> buffer;
+    const char* base = nullptr;
+    std::size_t files = 0;
+    std::size_t trigrams = 0;
+};
+
+/**
+ * @class IndexQuery
+ *
+ * @brief Decides per walked file whether it has to be searched
+ *
+ * @details Built once per run from the index and the patterns, then shared
+ * read-only by every thread that walks the tree. With several patterns a
+ * file is ruled out only if it cannot contain any of them.
+ */
+class IndexQuery {
+public:
+    IndexQuery(const TrigramIndex& index, const std::filesystem::path& rootDir, const std::vector<std::string>& patterns);
+
+    /**
+     * @brief Whether a file found during the walk must be searched
+     *
+     * @return false only for files that are in the index, unchanged since it
+     * was built, and missing at least one trigram of the target
+     */
+    bool mustSearch(const std::filesystem::directory_entry& entry) const;
+
+    std::size_t skippableFiles() const { return skippable; }
+
+private:
+    const TrigramIndex& index;
+    std::string rootPrefix;
+    bool narrowing = false;
+    std::vector<char> candidate;
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::size_t skippable = 0;
+};
+
+/**
+ * @brief Path of a walked file relative to the walk root, as stored in the index
+ *
+ * @param rootPrefix The walk root with a trailing separator
+ * @param p A path produced by walking from that root
+ */
+std::string indexKey(const std::string& rootPrefix, const std::filesystem::path& p);
+
+/**
+ * @brief The walk root with a trailing separator, for use with indexKey
+ */
+std::string indexRootPrefix(const std::filesystem::path& rootDir);
+
+/**
+ * @brief Modification time as stored in the index
+ */
+std::int64_t indexMtime(std::filesystem::file_time_type t);
+
+#endif // TRIGRAM_INDEX_H
@@ -0,0 +1,161 @@
+/**
+ * @file src/walk_rules.cpp
+ *
+ * @brief Implementation of the include/exclude globs and .gitignore handling used while walking.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of WalkRules. With no globs and no
+ * .gitignore in scope a file check is the same extension lookup as before,
+ * and a directory check is free; the relative path of an entry is only built
+ * when some rule may need it.
+ */
+
+#include "walk_rules.h"
+#include "producer.h"
+#include <fstream>
+#include <utility>
+
+/**
+ * @brief Compile the command-line globs
+ *
+ * @param rootDir The directory the walk starts from; globs with a "/" are relative to it
+ * @param includeGlobs Files must match one of these; empty keeps the default extensions
+ * @param excludeGlobs Files and directories matching any of these are skipped
+ * @param useGitignore Read .gitignore files and skip ".git" directories
+ */
+WalkRules::WalkRules(
+    const std::filesystem::path& rootDir,
+    const std::vector<std::string>& includeGlobs,
+    const std::vector<std::string>& excludeGlobs,
+    bool useGitignore
+) : root(rootDir.native()), gitignore(useGitignore) {
+    for (const std::string& glob : includeGlobs) {
+        if (std::optional<PathRule> rule = parsePathRule(glob)) {
+            includes.push_back(std::move(*rule));
+        }
+    }
+    for (const std::string& glob : excludeGlobs) {
+        if (std::optional<PathRule> rule = parsePathRule(glob)) {
+            excludes.push_back(std::move(*rule));
+        }
+    }
+}
+
+/**
+ * @brief The path of a walked entry relative to the walk root
+ */
+std::string WalkRules::relative(const std::filesystem::path& p) const {
+    const std::string& full = p.native();
+    std::size_t start = 0;
+    if (!root.empty() && full.compare(0, root.size(), root) == 0) {
+        start = root.size();
+    }
+    while (start < full.size() && full[start] == '/') {
+        ++start;
+    }
+    return full.substr(start);
+}
+
+/**
+ * @brief The scope for a directory about to be listed
+ *
+ * @param parent The scope of the directory's parent (nullptr for the walk root)
+ * @param dir The directory
+ *
+ * @return Scope A new scope if dir holds a .gitignore with rules, otherwise parent
+ */
+WalkRules::Scope WalkRules::enter(const Scope& parent, const std::filesystem::path& dir) const {
+    if (!gitignore) {
+        return parent;
+    }
+    std::ifstream in(dir / ".gitignore");
+    if (!in) {
+        return parent;
+    }
+    auto scope = std::make_shared<IgnoreScope>();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (std::optional<PathRule> rule = parsePathRule(line)) {
+            scope->rules.push_back(std::move(*rule));
+        }
+    }
+    if (scope->rules.empty()) {
+        return parent;
+    }
+    scope->base = relative(dir);
+    scope->parent = parent;
+    return scope;
+}
+
+/**
+ * @brief Whether an exclude glob or a .gitignore rule drops an entry
+ *
+ * @details The exclude globs win over everything. Then the scopes are tried
+ * from the nearest .gitignore outwards; within one file the last matching
+ * rule decides, and a negated rule keeps the entry.
+ */
+bool WalkRules::excluded(const Scope& scope, const std::string& rel, const std::string& name, bool isDirectory) const {
+    for (const PathRule& rule : excludes) {
+        if (rule.matches(rel, name, isDirectory)) {
+            return true;
+        }
+    }
+    for (const IgnoreScope* s = scope.get(); s; s = s->parent.get()) {
+        std::string local = s->base.empty() ? rel : rel.substr(s->base.size() + 1);
+        for (auto it = s->rules.rbegin(); it != s->rules.rend(); ++it) {
+            if (it->matches(local, name, isDirectory)) {
+                return !it->negate;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Whether to descend into a directory found in a directory with the given scope
+ */
+bool WalkRules::walkDirectory(const Scope& scope, const std::filesystem::directory_entry& entry) const {
+    if (!gitignore && excludes.empty()) {
+        return true;
+    }
+    std::string name = entry.path().filename().native();
+    if (gitignore && name == ".git") {
+        return false;
+    }
+    if (excludes.empty() && !scope) {
+        return true;
+    }
+    return !excluded(scope, relative(entry.path()), name, true);
+}
+
+/**
+ * @brief Whether to search a regular file found in a directory with the given scope
+ */
+bool WalkRules::searchFile(const Scope& scope, const std::filesystem::directory_entry& entry) const {
+    if (includes.empty() && excludes.empty() && !scope) {
+        return hasValidExtension(entry.path());
+    }
+    std::string name = entry.path().filename().native();
+    std::string rel = relative(entry.path());
+    if (includes.empty()) {
+        if (!hasValidExtension(entry.path())) {
+            return false;
+        }
+    } else {
+        bool included = false;
+        for (const PathRule& rule : includes) {
+            if (rule.matches(rel, name, false)) {
+                included = true;
+                break;
+            }
+        }
+        if (!included) {
+            return false;
+        }
+    }
+    return !excluded(scope, rel, name, false);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file src/walk_rules.h
+ *
+ * @brief Declaration of the rules that decide which directories and files a walk visits.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of WalkRules, which the producer, the
+ * parallel walker and the fused engine consult for every directory entry.
+ * It combines the --include and --exclude globs given on the command line
+ * with the .gitignore files found during the walk. Directories are checked
+ * as soon as they are listed, so an excluded or ignored directory is pruned
+ * with everything below it instead of being walked and filtered file by file.
+ */
+
+#ifndef WALK_RULES_H
+#define WALK_RULES_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "glob.h"
+
+/**
+ * @struct IgnoreScope
+ *
+ * @brief The rules of one .gitignore file and of every .gitignore above it
+ *
+ * @var base Directory holding the .gitignore, relative to the walk root ("" for the root)
+ * @var rules The file's rules in file order
+ * @var parent The scope of the nearest enclosing directory with a .gitignore, or nullptr
+ *
+ * @details Scopes are immutable and shared: every directory below a
+ * .gitignore that has none of its own uses the same scope, so a walk only
+ * allocates one per .gitignore file it reads.
+ */
+struct IgnoreScope {
+    std::string base;
+    std::vector<PathRule> rules;
+    std::shared_ptr<const IgnoreScope> parent;
+};
+
+/**
+ * @class WalkRules
+ *
+ * @brief Decides which directories to descend into and which files to search
+ *
+ * @details A file is searched if it matches one of the include globs (or,
+ * without any, has one of the default extensions, see hasValidExtension),
+ * matches no exclude glob and is not ignored by a .gitignore. A directory is
+ * descended into unless it matches an exclude glob or is ignored; with
+ * .gitignore handling on, ".git" directories are always skipped.
+ *
+ * Globs without a "/" are matched against the entry's name, others against
+ * its path relative to the walk root. A .gitignore applies to the directory it
+ * is in and everything below; the last matching rule of the nearest
+ * .gitignore wins, as in git. Only .gitignore files at or below the walk
+ * root are read.
+ *
+ * Walkers keep the Scope of the directory they are listing: enter() gives
+ * the scope for a directory from its parent's scope. A default WalkRules
+ * only applies the default extensions and never reads a .gitignore.
+ */
+class WalkRules {
+public:
+    using Scope = std::shared_ptr<const IgnoreScope>;
+
+    WalkRules() = default;
+    WalkRules(
+        const std::filesystem::path& rootDir,
+        const std::vector<std::string>& includeGlobs,
+        const std::vector<std::string>& excludeGlobs,
+        bool useGitignore
+    );
+
+    Scope enter(const Scope& parent, const std::filesystem::path& dir) const;
+    bool walkDirectory(const Scope& scope, const std::filesystem::directory_entry& entry) const;
+    bool searchFile(const Scope& scope, const std::filesystem::directory_entry& entry) const;
+
+private:
+    std::string relative(const std::filesystem::path& p) const;
+    bool excluded(const Scope& scope, const std::string& rel, const std::string& name, bool isDirectory) const;
+
+    std::string root;
+    std::vector<PathRule> includes;
+    std::vector<PathRule> excludes;
+    bool gitignore = false;
+};
+
+#endif // WALK_RULES_H
@@ -0,0 +1,113 @@
+/**
+ * @file src/walker.cpp
+ *
+ * @brief Implementation of the parallel, work-stealing directory walker.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the implementation of parallelWalkerFunc. The walker
+ * threads run a TreeWalk of directories (see tree_walk.h): listing a
+ * directory queues its subdirectories on the lister's own deque and batches
+ * its files into tasks for the file channel.
+ */
+
+#include "walker.h"
+#include "producer.h"
+#include "search_stats.h"
+#include "tree_walk.h"
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct WalkDir
+ *
+ * @brief A directory waiting to be listed
+ *
+ * @var path The directory
+ * @var scope The .gitignore scope of its parent; the lister reads its own .gitignore
+ */
+struct WalkDir {
+    std::filesystem::path path;
+    WalkRules::Scope scope;
+};
+
+/**
+ * @brief Body of one walker thread
+ *
+ * @param walk The directories shared by the walker threads
+ * @param self Index of this walker thread
+ * @param fileChan The channel to send file tasks through
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Rules out files that need not be searched, or nullptr
+ *
+ * @details Files are batched per thread. When a thread finds no directory
+ * anywhere it flushes its partial batch so workers are not kept waiting.
+ */
+static void walkerLoop(
+    TreeWalk<WalkDir>& walk,
+    unsigned int self,
+    channel<FileTask>* fileChan,
+    const WalkRules& rules,
+    const FileFilter* filter
+) {
+    StatsScope statsScope("walker");
+    std::vector<FileTask> batch;
+    batch.reserve(PRODUCER_BATCH_SIZE);
+    auto sendBatch = [&]() {
+        StatsTimer timer(&ThreadStats::file_send_wait);
+        fileChan->sendBatch(std::move(batch));
+        batch.clear();
+    };
+    auto onDirectory = [&](const std::filesystem::path& path, const WalkRules::Scope& scope) {
+        walk.push(self, WalkDir{path, scope});
+    };
+    auto onFile = [&](const std::filesystem::directory_entry& entry) {
+        std::error_code sizeEc;
+        std::uintmax_t size = entry.file_size(sizeEc);
+        appendFileTasks(entry.path(), sizeEc ? 0 : size, batch);
+        if (batch.size() >= PRODUCER_BATCH_SIZE) {
+            sendBatch();
+        }
+    };
+
+    walk.run(self, [&](const WalkDir& dir) {
+        try {
+            listWalkDirectory(rules, filter, dir.path, dir.scope, onDirectory, onFile);
+        } catch (const std::exception& e) {
+            std::cerr << "Error during directory traversal: " << e.what() << std::endl;
+        }
+    }, [&]() {
+        if (!batch.empty()) {
+            sendBatch();
+        }
+    });
+}
+
+void parallelWalkerFunc(
+    const std::filesystem::path& rootDir,
+    channel<FileTask>* fileChan,
+    unsigned int walkerThreads,
+    const WalkRules& rules,
+    const FileFilter* filter
+) {
+    if (walkerThreads == 0) walkerThreads = 1;
+
+    TreeWalk<WalkDir> walk(walkerThreads);
+    walk.push(0, WalkDir{rootDir, nullptr});
+
+    std::vector<std::thread> walkers;
+    walkers.reserve(walkerThreads);
+    for (unsigned int i = 0; i < walkerThreads; ++i) {
+        walkers.emplace_back(walkerLoop, std::ref(walk), i, fileChan, std::cref(rules), filter);
+    }
+    for (auto& walker : walkers) {
+        walker.join();
+    }
+
+    fileChan->close();
+}
@@ -0,0 +1,57 @@
+/**
+ * @file src/walker.h
+ *
+ * @brief Declaration of the parallel, work-stealing directory walker.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the declaration of the parallel walker thread function,
+ * a drop-in replacement for producerThreadFunc on wide or slow (network)
+ * directory trees. Directories are the unit of work: each walker thread
+ * lists one directory at a time, queues its subdirectories on its own
+ * deque, and sends the matching files to the same file channel the single
+ * producer would use.
+ */
+
+#ifndef WALKER_H
+#define WALKER_H
+
+#include <filesystem>
+#include "channel.h"
+#include "file_task.h"
+#include "file_filter.h"
+#include "walk_rules.h"
+
+/**
+ * @brief Walk a directory tree with several threads and send file tasks
+ *
+ * @param rootDir The root directory to start traversal
+ * @param fileChan The channel to send file tasks through
+ * @param walkerThreads Number of threads to walk with
+ * @param rules Which directories to descend into and which files to search
+ * @param filter Files this rules out are not sent; nullptr sends every file
+ *
+ * @return void
+ *
+ * @details This function starts walkerThreads threads that share the
+ * traversal through per-thread workStealingDeques of directories. A thread
+ * pops directories from its own deque and steals from the other threads when
+ * its deque runs dry. Directories the walk rules reject are never queued, and
+ * each queued directory carries its parent's .gitignore scope. Files the rules
+ * accept are turned into FileTasks
+ * with appendFileTasks, batched per thread and sent through the file channel. The walk is finished once no directory is
+ * queued or being listed; the function then joins its threads and closes the
+ * channel, just like producerThreadFunc.
+ */
+void parallelWalkerFunc(
+    const std::filesystem::path& rootDir,
+    channel<FileTask>* fileChan,
+    unsigned int walkerThreads,
+    const WalkRules& rules,
+    const FileFilter* filter
+);
+
+#endif // WALKER_H
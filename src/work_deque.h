@@ -0,0 +1,77 @@
+/**
+ * @file src/work_deque.h
+ *
+ * @brief Declaration and implementation of a per-thread work-stealing deque.
+ *
+ * @author Samii Shabuse <sus24@drexel.edu>
+ * @date October 17, 2026
+ *
+ * @section Overview
+ *
+ * This file contains the workStealingDeque template used by the parallel
+ * directory walker. Each thread owns one deque and pushes/pops work at the
+ * bottom (newest first, which keeps a depth-first walk cache friendly),
+ * while idle threads steal from the top of other threads' deques (oldest
+ * first, which tends to hand out the largest remaining subtrees). Each deque
+ * has its own mutex, so the lock is only contended when a steal happens.
+ */
+
+#ifndef WORK_DEQUE_H
+#define WORK_DEQUE_H
+
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @class workStealingDeque
+ *
+ * @brief Deque with an owner end and a thief end
+ *
+ * @details push and pop are meant for the owning thread; steal may be called
+ * from any thread. All operations are thread safe. Aligned to a cache line so
+ * neighbouring deques in an array do not share one.
+ */
+template <class T>
+class alignas(64) workStealingDeque {
+public:
+    /**
+     * @brief Add work at the owner's end
+     */
+    void push(T item) {
+        std::lock_guard<std::mutex> lk(mut);
+        items.push_back(std::move(item));
+    }
+
+    /**
+     * @brief Take the newest work from the owner's end
+     *
+     * @return true if an item was taken, false if the deque was empty
+     */
+    bool pop(T& item) {
+        std::lock_guard<std::mutex> lk(mut);
+        if (items.empty()) return false;
+        item = std::move(items.back());
+        items.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest work from the thief's end
+     *
+     * @return true if an item was taken, false if the deque was empty
+     */
+    bool steal(T& item) {
+        std::lock_guard<std::mutex> lk(mut);
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mut;
+    std::deque<T> items;
+};
+
+#endif // WORK_DEQUE_H